@@ -5,6 +5,7 @@
 #include <sstream>
 #include <string>
 #include <vector>
+#include "thread/ParallelUtil.hpp"
 
 namespace common::io
 {
@@ -136,6 +137,17 @@ public:
 		std::sort(array + fromIndex, array + toIndex);
 	}
 
+	/// \brief Sorts the specified array in ascending order using a thread pool.
+	/// \details This method sorts the specified array in ascending order.
+	/// It uses a parallel merge sort running on the given pool; small arrays are sorted with std::sort.
+	/// \tparam T The type of elements in the array.
+	/// \param pool The thread pool that executes the sort.
+	/// \param array A pointer to the array to be sorted.
+	/// \param size The size of the array.
+	template <typename T> static auto sort(thread::ThreadPool& pool, T* array, size_t size) -> void {
+		thread::ParallelUtil::ParallelSort(pool, array, array + size);
+	}
+
 	/// \brief Converts the specified array to a string representation.
 	/// \details This method generates a string representation of the specified array.
 	/// The string representation is a comma-separated list of elements within square brackets.
@@ -20,12 +20,30 @@ auto AbstractInputStream::markSupported() const -> bool {
 	return false;
 }
 
+/// \brief Reads bytes into the specified memory.
+/// \details Attempts to read up to buffer.size() bytes, one byte at a time. Subclasses able to transfer
+/// whole blocks override this method.
+/// \param buffer The memory into which the data is read.
+/// \return The total number of bytes read into the buffer.
+auto AbstractInputStream::read(const std::span<std::byte> buffer) -> size_t {
+	size_t bytesRead = 0;
+	for (std::byte& target : buffer) {
+		const std::byte byte = read();
+		if (byte == static_cast<std::byte>(-1)) {
+			break;
+		}
+		target = byte;
+		++bytesRead;
+	}
+	return bytesRead;
+}
+
 /// \brief Reads bytes into the specified buffer.
 /// \details Attempts to read up to buffer.size() bytes into the provided buffer vector.
 /// \param buffer The buffer into which the data is read.
 /// \return The total number of bytes read into the buffer, or -1 if the end of the stream has been reached.
 auto AbstractInputStream::read(std::vector<std::byte>& buffer) -> size_t {
-	return read(buffer, 0, static_cast<int>(buffer.size()));
+	return read(std::span(buffer));
 }
 
 /// \brief Reads bytes into the specified buffer.
@@ -34,20 +52,12 @@ auto AbstractInputStream::read(std::vector<std::byte>& buffer) -> size_t {
 /// \param offset The starting position in the buffer.
 /// \param len The maximum number of bytes to read.
 /// \return The total number of bytes read into the buffer, or -1 if the end of the stream has been reached.
+/// \throws std::out_of_range if the range does not lie within the buffer.
 auto AbstractInputStream::read(std::vector<std::byte>& buffer, const size_t offset, const size_t len) -> size_t {
-	if (offset + len > buffer.size()) {
+	if (offset > buffer.size() || len > buffer.size() - offset) {
 		throw std::out_of_range("Buffer offset/length out of range");
 	}
-	size_t bytesRead = 0;
-	for (int i = 0; i < len; ++i) {
-		const std::byte byte = read();
-		if (byte == static_cast<std::byte>(-1)) {
-			break;
-		}
-		buffer[offset + i] = static_cast<std::byte>(byte);
-		++bytesRead;
-	}
-	return bytesRead;
+	return read(std::span(buffer).subspan(offset, len));
 }
 
 /// \brief Resets the input stream to the last marked position.
@@ -2,6 +2,7 @@
 // Copyright (c) 2024 ethereal. All rights reserved.
 #pragma once
 #include <fstream>
+#include <span>
 #include <vector>
 #include "interface/IfaceCloseable.hpp"
 
@@ -11,6 +12,8 @@ namespace common::io
 /// \details This abstract class provides a general interface for input streams.
 /// It declares methods for reading from the stream, marking the stream, and resetting the stream.
 /// The available method returns the number of bytes that can be read from the stream without blocking.
+/// Bulk reads go through the span overload, which subclasses override to fill the caller's memory directly;
+/// the vector overloads only validate their arguments and delegate to it.
 class AbstractInputStream abstract : public interface::IfaceCloseable
 {
 public:
@@ -19,6 +22,7 @@ public:
 	virtual auto mark(int readLimit) -> void;
 	[[nodiscard]] virtual auto markSupported() const -> bool;
 	virtual auto read() -> std::byte = 0;
+	virtual auto read(std::span<std::byte> buffer) -> size_t;
 	virtual auto read(std::vector<std::byte>& buffer) -> size_t;
 	virtual auto read(std::vector<std::byte>& buffer, size_t offset, size_t len) -> size_t;
 	virtual auto reset() -> void;
@@ -4,11 +4,20 @@
 
 namespace common::io
 {
+/// \brief Writes a block of memory to the output stream.
+/// \param buffer The bytes to be written.
+/// \details This function writes the bytes one at a time. Subclasses able to transfer whole blocks override it.
+auto AbstractOutputStream::write(const std::span<const std::byte> buffer) -> void {
+	for (const std::byte byte : buffer) {
+		write(byte);
+	}
+}
+
 /// \brief Writes the entire buffer to the output stream.
 /// \param buffer The buffer to be written.
 /// \details This function writes the entire buffer to the output stream.
 auto AbstractOutputStream::write(const std::vector<std::byte>& buffer) -> void {
-	write(buffer, 0, static_cast<int>(buffer.size()));
+	write(std::span(buffer));
 }
 
 /// \brief Writes a portion of the buffer to the output stream.
@@ -16,12 +25,11 @@ auto AbstractOutputStream::write(const std::vector<std::byte>& buffer) -> void {
 /// \param offset The starting offset in the buffer.
 /// \param len The number of bytes to be written.
 /// \details This function writes \p len bytes from the buffer starting at \p offset to the output stream.
+/// \throws std::out_of_range if the range does not lie within the buffer.
 auto AbstractOutputStream::write(const std::vector<std::byte>& buffer, const size_t offset, const size_t len) -> void {
-	if (offset + len > buffer.size()) {
+	if (offset > buffer.size() || len > buffer.size() - offset) {
 		throw std::out_of_range("Buffer offset/length out of range");
 	}
-	for (int i = 0; i < len; ++i) {
-		write(buffer[offset + i]);
-	}
+	write(std::span(buffer).subspan(offset, len));
 }
 }
@@ -2,6 +2,7 @@
 // Copyright (c) 2024 ethereal. All rights reserved.
 #pragma once
 #include <format>
+#include <span>
 #include <vector>
 #include "interface/IfaceCloseable.hpp"
 #include "interface/IfaceFlushable.hpp"
@@ -12,11 +13,14 @@ namespace common::io
 /// \details This class provides an interface for objects that can be written to.
 /// It is a base class for classes that implement output streams.
 /// It is an abstract class that cannot be instantiated.
+/// Bulk writes go through the span overload, which subclasses override to consume the caller's memory directly;
+/// the vector overloads only validate their arguments and delegate to it.
 class AbstractOutputStream abstract : public interface::IfaceCloseable, public interface::IfaceFlushable
 {
 public:
 	~AbstractOutputStream() override = default;
 	virtual auto write(std::byte b) -> void = 0;
+	virtual auto write(std::span<const std::byte> buffer) -> void;
 	virtual auto write(const std::vector<std::byte>& buffer) -> void;
 	virtual auto write(const std::vector<std::byte>& buffer, size_t offset, size_t len) -> void;
 };
@@ -0,0 +1,536 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#include "AsyncFileEngine.hpp"
+// POSIX only, like FileDescriptor.
+#ifndef _WIN32
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ios>
+#include <system_error>
+#include <vector>
+#include <unistd.h>
+#include "thread/DiscardGuard.hpp"
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+namespace common::io
+{
+#ifdef __linux__
+namespace
+{
+/// \brief Tests whether the kernel supports every opcode the engine submits.
+/// \details io_uring_setup works from Linux 5.1, but IORING_OP_READ and IORING_OP_WRITE only exist from
+/// 5.6, where the probe was added as well; a kernel that cannot be probed is too old.
+/// \param ringFd The ring to probe.
+auto supportsTransfers(const int ringFd) -> bool {
+	constexpr unsigned OP_COUNT = 256;
+	std::vector<std::byte> storage(sizeof(io_uring_probe) + OP_COUNT * sizeof(io_uring_probe_op));
+	auto* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+	if (syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_PROBE, probe, OP_COUNT) < 0) {
+		return false;
+	}
+	for (const unsigned op : {IORING_OP_NOP, IORING_OP_READ, IORING_OP_WRITE, IORING_OP_READ_FIXED, IORING_OP_WRITE_FIXED}) {
+		if (op > probe->last_op || (probe->ops[op].flags & IO_URING_OP_SUPPORTED) == 0) {
+			return false;
+		}
+	}
+	return true;
+}
+}
+#endif
+
+/// \brief Creates an engine, using io_uring when the kernel allows it.
+/// \param pool The pool running callbacks and, without io_uring, the transfers themselves.
+/// \param queueDepth The maximum number of requests in flight; further submissions wait for room.
+/// \throws std::invalid_argument if the queue depth is zero.
+AsyncFileEngine::AsyncFileEngine(thread::ThreadPool& pool, const unsigned queueDepth) : pool_(pool), ring_(), ioUring_(false) {
+	if (queueDepth == 0) {
+		throw std::invalid_argument("Queue depth must be greater than zero");
+	}
+	ioUring_ = setupRing(queueDepth);
+	if (ioUring_) {
+		reaper_ = std::thread([this] {
+			reapLoop();
+		});
+	}
+	else {
+		ring_.entries = queueDepth;
+	}
+}
+
+/// \brief Waits for every request in flight, then stops the engine.
+AsyncFileEngine::~AsyncFileEngine() {
+	std::unique_lock lock(mutex_);
+	stop_ = true;
+	room_.wait(lock, [this] {
+		return inFlight_ == 0;
+	});
+#ifdef __linux__
+	if (ioUring_) {
+		// A no-op with a null user_data tells the reaper to exit.
+		const unsigned tail = ring_.sqTail->load(std::memory_order_relaxed);
+		const unsigned index = tail & ring_.sqMask;
+		io_uring_sqe& sqe = static_cast<io_uring_sqe*>(ring_.sqes)[index];
+		std::memset(&sqe, 0, sizeof(sqe));
+		sqe.opcode = IORING_OP_NOP;
+		ring_.sqArray[index] = index;
+		ring_.sqTail->store(tail + 1, std::memory_order_release);
+		enter(1, 0, 0);
+		lock.unlock();
+		reaper_.join();
+		teardownRing();
+	}
+#endif
+}
+
+/// \brief Tests whether requests go through io_uring rather than the thread pool fallback.
+auto AsyncFileEngine::usesIoUring() const -> bool {
+	return ioUring_;
+}
+
+/// \brief Reads a range of a file until the buffer is full or end of file is reached.
+/// \param fd The file.
+/// \param buffer The memory to read into.
+/// \param offset The file offset of the first byte.
+/// \return A future for the number of bytes read; it holds a std::ios_base::failure on error.
+auto AsyncFileEngine::read(const FileDescriptor& fd, const std::span<std::byte> buffer, const uint64_t offset) -> std::future<size_t> {
+	auto promise = std::make_shared<std::promise<size_t>>();
+	auto future = promise->get_future();
+	read(fd, buffer, offset, promiseCallback(std::move(promise)));
+	return future;
+}
+
+/// \brief Writes a whole buffer at a given offset of a file.
+/// \param fd The file.
+/// \param buffer The bytes to write.
+/// \param offset The file offset of the first byte.
+/// \return A future for the number of bytes written; it holds a std::ios_base::failure on error.
+auto AsyncFileEngine::write(const FileDescriptor& fd, const std::span<const std::byte> buffer, const uint64_t offset) -> std::future<size_t> {
+	auto promise = std::make_shared<std::promise<size_t>>();
+	auto future = promise->get_future();
+	write(fd, buffer, offset, promiseCallback(std::move(promise)));
+	return future;
+}
+
+/// \brief Reads a range of a file and passes the outcome to a callback running on the pool.
+auto AsyncFileEngine::read(const FileDescriptor& fd, const std::span<std::byte> buffer, const uint64_t offset, Callback callback) -> void {
+	std::vector<Request> requests(1);
+	requests[0] = {Operation::Read, &fd, buffer, offset, std::move(callback)};
+	submit(std::move(requests));
+}
+
+/// \brief Writes a buffer to a file and passes the outcome to a callback running on the pool.
+auto AsyncFileEngine::write(const FileDescriptor& fd, const std::span<const std::byte> buffer, const uint64_t offset, Callback callback) -> void {
+	std::vector<Request> requests(1);
+	// The buffer is only read from; the non-const span just lets reads and writes share Request.
+	requests[0] = {Operation::Write, &fd, std::span(const_cast<std::byte*>(buffer.data()), buffer.size()), offset, std::move(callback)};
+	submit(std::move(requests));
+}
+
+/// \brief Submits several requests at once.
+/// \details With io_uring, the requests are queued into the submission ring and handed to the kernel with
+/// one system call per ring-full. Each request reports through its own callback, which runs on the pool;
+/// that includes requests the kernel refuses to take, which fail with a std::ios_base::failure.
+/// \param requests The requests.
+/// \throws std::invalid_argument if a request has no file.
+/// \throws std::runtime_error if the engine is being destroyed.
+auto AsyncFileEngine::submit(std::vector<Request> requests) -> void {
+	std::vector<std::unique_ptr<Pending>> pending;
+	pending.reserve(requests.size());
+	for (Request& request : requests) {
+		if (request.fd == nullptr || !request.fd->isOpen()) {
+			throw std::invalid_argument("Request has no open file");
+		}
+		pending.push_back(std::make_unique<Pending>(Pending{request.operation, request.fd->get(), request.buffer.data(), request.buffer.size(), request.offset, 0, -1, std::move(request.callback)}));
+	}
+	if (!ioUring_) {
+		for (auto& request : pending) {
+			enqueue(std::move(request));
+		}
+		return;
+	}
+#ifdef __linux__
+	std::unique_lock lock(mutex_);
+	if (stop_) {
+		throw std::runtime_error("Async file engine is shutting down");
+	}
+	size_t next = 0;
+	size_t failed = pending.size();
+	int error = 0;
+	while (next < pending.size()) {
+		room_.wait(lock, [this] {
+			return inFlight_ < ring_.entries;
+		});
+		const size_t first = next;
+		while (next < pending.size() && inFlight_ < ring_.entries) {
+			Pending& request = *pending[next++];
+			request.bufferIndex = findRegisteredBuffer(request.data, request.size);
+			queueEntry(request);
+			++inFlight_;
+		}
+		const unsigned unsent = submitEntries();
+		for (size_t i = first; i < next - unsent; ++i) {
+			// The kernel owns the request now; the reaper frees it on completion.
+			static_cast<void>(pending[i].release());
+		}
+		if (unsent > 0) {
+			error = errno;
+			failed = next - unsent;
+			// The requests never queued take a slot as well, so that finish releases one for each of them.
+			inFlight_ += pending.size() - next;
+			break;
+		}
+	}
+	lock.unlock();
+	for (size_t i = failed; i < pending.size(); ++i) {
+		finish(std::move(pending[i]), std::make_exception_ptr(std::ios_base::failure("IOException: io_uring submission failed.", std::error_code(error, std::generic_category()))));
+	}
+#endif
+}
+
+/// \brief Registers buffers for fixed-buffer transfers.
+/// \details Requests whose memory lies entirely within a registered buffer use the fixed-buffer opcodes,
+/// sparing the kernel from pinning the pages on every request. Waits until no request is in flight.
+/// Without io_uring, registration is accepted and has no effect.
+/// \param buffers The buffers; they must stay valid until unregisterBuffers or destruction.
+/// \throws std::ios_base::failure if the kernel refuses the registration, e.g. over the locked memory limit.
+auto AsyncFileEngine::registerBuffers(const std::span<const std::span<std::byte>> buffers) -> void {
+	std::unique_lock lock(mutex_);
+	room_.wait(lock, [this] {
+		return inFlight_ == 0;
+	});
+#ifdef __linux__
+	if (ioUring_) {
+		if (!registered_.empty()) {
+			syscall(__NR_io_uring_register, ring_.fd, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+			registered_.clear();
+		}
+		std::vector<iovec> iov;
+		iov.reserve(buffers.size());
+		for (const auto& buffer : buffers) {
+			iov.push_back({buffer.data(), buffer.size()});
+		}
+		if (syscall(__NR_io_uring_register, ring_.fd, IORING_REGISTER_BUFFERS, iov.data(), static_cast<unsigned>(iov.size())) < 0) {
+			throw std::ios_base::failure("IOException: Unable to register buffers.", std::error_code(errno, std::generic_category()));
+		}
+	}
+#endif
+	registered_.assign(buffers.begin(), buffers.end());
+}
+
+/// \brief Unregisters the buffers registered by registerBuffers. Waits until no request is in flight.
+auto AsyncFileEngine::unregisterBuffers() -> void {
+	std::unique_lock lock(mutex_);
+	room_.wait(lock, [this] {
+		return inFlight_ == 0;
+	});
+#ifdef __linux__
+	if (ioUring_ && !registered_.empty()) {
+		syscall(__NR_io_uring_register, ring_.fd, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+	}
+#endif
+	registered_.clear();
+}
+
+/// \brief Adapts a promise to the callback interface.
+auto AsyncFileEngine::promiseCallback(std::shared_ptr<std::promise<size_t>> promise) -> Callback {
+	return [promise = std::move(promise)](const size_t bytes, const std::exception_ptr& error) {
+		if (error) {
+			promise->set_exception(error);
+		}
+		else {
+			promise->set_value(bytes);
+		}
+	};
+}
+
+/// \brief Creates and maps the io_uring rings.
+/// \return false if io_uring is not available, in which case the fallback is used.
+auto AsyncFileEngine::setupRing([[maybe_unused]] const unsigned queueDepth) -> bool {
+#ifdef __linux__
+	io_uring_params params{};
+	const auto fd = static_cast<int>(syscall(__NR_io_uring_setup, queueDepth, &params));
+	if (fd < 0) {
+		return false;
+	}
+	ring_.fd = fd;
+	if (!supportsTransfers(fd)) {
+		teardownRing();
+		return false;
+	}
+	ring_.sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	ring_.cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+	const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+	if (singleMap) {
+		ring_.sqRingSize = ring_.cqRingSize = std::max(ring_.sqRingSize, ring_.cqRingSize);
+	}
+	ring_.sqRing = mmap(nullptr, ring_.sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+	if (ring_.sqRing == MAP_FAILED) {
+		ring_.sqRing = nullptr;
+		teardownRing();
+		return false;
+	}
+	if (singleMap) {
+		ring_.cqRing = ring_.sqRing;
+	}
+	else {
+		ring_.cqRing = mmap(nullptr, ring_.cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+		if (ring_.cqRing == MAP_FAILED) {
+			ring_.cqRing = nullptr;
+			teardownRing();
+			return false;
+		}
+	}
+	ring_.sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+	ring_.sqes = mmap(nullptr, ring_.sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+	if (ring_.sqes == MAP_FAILED) {
+		ring_.sqes = nullptr;
+		teardownRing();
+		return false;
+	}
+	auto* sq = static_cast<std::byte*>(ring_.sqRing);
+	auto* cq = static_cast<std::byte*>(ring_.cqRing);
+	ring_.sqHead = reinterpret_cast<std::atomic<unsigned>*>(sq + params.sq_off.head);
+	ring_.sqTail = reinterpret_cast<std::atomic<unsigned>*>(sq + params.sq_off.tail);
+	ring_.sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+	ring_.sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+	ring_.cqHead = reinterpret_cast<std::atomic<unsigned>*>(cq + params.cq_off.head);
+	ring_.cqTail = reinterpret_cast<std::atomic<unsigned>*>(cq + params.cq_off.tail);
+	ring_.cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+	ring_.cqes = cq + params.cq_off.cqes;
+	// Keeping at most sq_entries requests in flight guarantees the completion ring, which is larger, never overflows.
+	ring_.entries = params.sq_entries;
+	return true;
+#else
+	return false;
+#endif
+}
+
+/// \brief Unmaps the rings and closes the ring descriptor.
+auto AsyncFileEngine::teardownRing() -> void {
+#ifdef __linux__
+	if (ring_.sqes) {
+		munmap(ring_.sqes, ring_.sqesSize);
+	}
+	if (ring_.cqRing && ring_.cqRing != ring_.sqRing) {
+		munmap(ring_.cqRing, ring_.cqRingSize);
+	}
+	if (ring_.sqRing) {
+		munmap(ring_.sqRing, ring_.sqRingSize);
+	}
+	if (ring_.fd >= 0) {
+		::close(ring_.fd);
+	}
+#endif
+	ring_ = Ring();
+}
+
+/// \brief Runs a request on the pool when io_uring is not available.
+/// \details Bounds the requests in flight to the queue depth like the ring does. A request the pool
+/// rejects, or discards before running it, fails with a std::ios_base::failure, which releases its slot.
+auto AsyncFileEngine::enqueue(std::unique_ptr<Pending> pending) -> void {
+	{
+		std::unique_lock lock(mutex_);
+		if (stop_) {
+			throw std::runtime_error("Async file engine is shutting down");
+		}
+		room_.wait(lock, [this] {
+			return inFlight_ < ring_.entries;
+		});
+		++inFlight_;
+	}
+	auto* request = pending.release();
+	thread::DiscardGuard guard([this, request]() noexcept {
+		finish(std::unique_ptr<Pending>(request), std::make_exception_ptr(std::ios_base::failure("IOException: Request was rejected or discarded by the thread pool.")));
+	});
+	pool_.TryExecute([this, request, guard = std::move(guard)]() mutable {
+		guard.Dismiss();
+		runFallback(std::unique_ptr<Pending>(request));
+	});
+}
+
+/// \brief Writes the submission queue entry of a request. Must be called with mutex_ held.
+auto AsyncFileEngine::queueEntry([[maybe_unused]] Pending& pending) -> void {
+#ifdef __linux__
+	const unsigned tail = ring_.sqTail->load(std::memory_order_relaxed);
+	const unsigned index = tail & ring_.sqMask;
+	io_uring_sqe& sqe = static_cast<io_uring_sqe*>(ring_.sqes)[index];
+	std::memset(&sqe, 0, sizeof(sqe));
+	const bool fixed = pending.bufferIndex >= 0;
+	if (pending.operation == Operation::Read) {
+		sqe.opcode = fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+	}
+	else {
+		sqe.opcode = fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+	}
+	sqe.fd = pending.fd;
+	sqe.off = pending.offset + pending.done;
+	sqe.addr = reinterpret_cast<uint64_t>(pending.data + pending.done);
+	sqe.len = static_cast<uint32_t>(std::min<size_t>(pending.size - pending.done, UINT32_MAX >> 1));
+	if (fixed) {
+		sqe.buf_index = static_cast<uint16_t>(pending.bufferIndex);
+	}
+	sqe.user_data = reinterpret_cast<uint64_t>(&pending);
+	ring_.sqArray[index] = index;
+	ring_.sqTail->store(tail + 1, std::memory_order_release);
+#endif
+}
+
+/// \brief Hands every queued submission queue entry to the kernel. Must be called with mutex_ held.
+/// \details Short submissions are retried for the rest. When the kernel takes none of the remaining entries,
+/// they are removed from the ring again, so a later call cannot submit them behind the caller's back. All
+/// submissions happen under mutex_, so those are always the entries queued last.
+/// \return The number of entries not submitted, 0 on success; errno then holds the error.
+auto AsyncFileEngine::submitEntries() -> unsigned {
+#ifdef __linux__
+	const unsigned tail = ring_.sqTail->load(std::memory_order_relaxed);
+	unsigned unsent = tail - ring_.sqHead->load(std::memory_order_acquire);
+	while (unsent > 0) {
+		const int result = enter(unsent, 0, 0);
+		unsent = tail - ring_.sqHead->load(std::memory_order_acquire);
+		if (result <= 0 && unsent > 0) {
+			if (result == 0) {
+				errno = EAGAIN;
+			}
+			ring_.sqTail->store(tail - unsent, std::memory_order_release);
+			return unsent;
+		}
+	}
+#endif
+	return 0;
+}
+
+/// \brief Calls io_uring_enter, retrying on EINTR.
+auto AsyncFileEngine::enter([[maybe_unused]] const unsigned toSubmit, [[maybe_unused]] const unsigned minComplete, [[maybe_unused]] const unsigned flags) const -> int {
+#ifdef __linux__
+	while (true) {
+		const auto result = static_cast<int>(syscall(__NR_io_uring_enter, ring_.fd, toSubmit, minComplete, flags, nullptr, 0));
+		if (result >= 0 || errno != EINTR) return result;
+	}
+#else
+	return -1;
+#endif
+}
+
+/// \brief The body of the reaper thread: waits for completions and dispatches them.
+auto AsyncFileEngine::reapLoop() -> void {
+#ifdef __linux__
+	bool running = true;
+	while (running) {
+		enter(0, 1, IORING_ENTER_GETEVENTS);
+		unsigned head = ring_.cqHead->load(std::memory_order_relaxed);
+		const unsigned tail = ring_.cqTail->load(std::memory_order_acquire);
+		if (head != tail) {
+			// The requests were published to the kernel, not to this thread; passing through the mutex their
+			// submitters held orders their writes before the reads below in the C++ memory model as well.
+			std::lock_guard lock(mutex_);
+		}
+		while (head != tail) {
+			const io_uring_cqe& cqe = static_cast<const io_uring_cqe*>(ring_.cqes)[head & ring_.cqMask];
+			auto* pending = reinterpret_cast<Pending*>(cqe.user_data);
+			const int result = cqe.res;
+			++head;
+			ring_.cqHead->store(head, std::memory_order_release);
+			if (pending == nullptr) {
+				running = false;
+				continue;
+			}
+			complete(pending, result);
+		}
+	}
+#endif
+}
+
+/// \brief Handles the completion of one transfer, resubmitting the remainder of a short one.
+auto AsyncFileEngine::complete(Pending* pending, const int result) -> void {
+	if (result == -EINTR || result == -EAGAIN || (result > 0 && pending->done + static_cast<size_t>(result) < pending->size)) {
+		if (result > 0) {
+			pending->done += static_cast<size_t>(result);
+		}
+		int error;
+		{
+			std::lock_guard lock(mutex_);
+			queueEntry(*pending);
+			if (submitEntries() == 0) return;
+			error = errno;
+		}
+		finish(std::unique_ptr<Pending>(pending), std::make_exception_ptr(std::ios_base::failure("IOException: io_uring submission failed.", std::error_code(error, std::generic_category()))));
+		return;
+	}
+	std::unique_ptr<Pending> request(pending);
+	if (result < 0) {
+		finish(std::move(request), std::make_exception_ptr(std::ios_base::failure("IOException: Asynchronous transfer failed.", std::error_code(-result, std::generic_category()))));
+		return;
+	}
+	if (result == 0 && request->operation == Operation::Write && request->done < request->size) {
+		finish(std::move(request), std::make_exception_ptr(std::ios_base::failure("IOException: Write made no progress.")));
+		return;
+	}
+	request->done += static_cast<size_t>(result);
+	finish(std::move(request), nullptr);
+}
+
+/// \brief Delivers the outcome of a finished request through the pool and releases its slot.
+/// \details Runs the callback inline when the pool does not accept it, and always inline in fallback mode,
+/// where this already runs on a pool worker. The slot is released last, so the engine is not destroyed
+/// while this is still using it.
+auto AsyncFileEngine::finish(std::unique_ptr<Pending> pending, std::exception_ptr error) -> void {
+	const size_t bytes = pending->done;
+	if (Callback callback = std::move(pending->callback)) {
+		pending.reset();
+		auto shared = std::make_shared<Callback>(std::move(callback));
+		if (!ioUring_ || !pool_.TryExecute([shared, bytes, error] {
+			(*shared)(bytes, error);
+		})) {
+			(*shared)(bytes, error);
+		}
+	}
+	std::lock_guard lock(mutex_);
+	--inFlight_;
+	room_.notify_all();
+}
+
+/// \brief Performs a request with blocking positional calls on a pool worker.
+auto AsyncFileEngine::runFallback(std::unique_ptr<Pending> pending) -> void {
+	std::exception_ptr error;
+	try {
+		while (pending->done < pending->size) {
+			const ssize_t n = pending->operation == Operation::Read
+				? ::pread(pending->fd, pending->data + pending->done, pending->size - pending->done, static_cast<off_t>(pending->offset + pending->done))
+				: ::pwrite(pending->fd, pending->data + pending->done, pending->size - pending->done, static_cast<off_t>(pending->offset + pending->done));
+			if (n < 0) {
+				if (errno == EINTR) continue;
+				throw std::ios_base::failure("IOException: Asynchronous transfer failed.", std::error_code(errno, std::generic_category()));
+			}
+			if (n == 0) {
+				if (pending->operation == Operation::Write) {
+					throw std::ios_base::failure("IOException: Write made no progress.");
+				}
+				break;
+			}
+			pending->done += static_cast<size_t>(n);
+		}
+	}
+	catch (...) {
+		error = std::current_exception();
+	}
+	finish(std::move(pending), error);
+}
+
+/// \brief Returns the index of the registered buffer containing a range, or -1.
+auto AsyncFileEngine::findRegisteredBuffer(const std::byte* data, const size_t size) const -> int {
+	for (size_t i = 0; i < registered_.size(); ++i) {
+		const auto& buffer = registered_[i];
+		if (data >= buffer.data() && data + size <= buffer.data() + buffer.size()) {
+			return static_cast<int>(i);
+		}
+	}
+	return -1;
+}
+}
+#endif
@@ -0,0 +1,129 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+#include "FileDescriptor.hpp"
+#include "thread/ThreadPool.hpp"
+
+namespace common::io
+{
+/// \brief Asynchronous positional file I/O backed by io_uring, with a ThreadPool fallback.
+/// \details Requests are queued into an io_uring submission ring and a whole batch is handed to the kernel
+/// with a single system call; a reaper thread collects the completions. Short transfers are resubmitted
+/// for the remainder, so a read completes with fewer bytes than requested only at end of file. Buffers
+/// registered with registerBuffers are pinned once and used with the fixed-buffer opcodes, which saves
+/// the kernel from mapping them on every request. When io_uring is unavailable (a kernel older than 5.6,
+/// seccomp, or a POSIX system other than Linux), every request runs as a blocking pread/pwrite task on
+/// the pool instead; the interface and its guarantees are the same either way.
+///
+/// Results are delivered through a std::future, fulfilled on the reaper thread, or through a callback,
+/// which runs on the pool. The descriptor and the buffer of a request must stay valid until it completes.
+/// Waiting on a future from a pool worker can deadlock in fallback mode when every worker waits, so keep
+/// consumers off the pool or size it accordingly.
+/// \remark POSIX only, like FileDescriptor.
+class AsyncFileEngine final
+{
+public:
+	/// \brief Receives the outcome of a request: the number of bytes transferred, or the error.
+	using Callback = std::function<void(size_t bytes, std::exception_ptr error)>;
+
+	/// \brief The kind of transfer of a Request.
+	enum class Operation
+	{
+		Read,
+		Write
+	};
+
+	/// \brief One positional transfer of a batch.
+	struct Request
+	{
+		Operation operation{Operation::Read};
+		const FileDescriptor* fd{nullptr};
+		std::span<std::byte> buffer;
+		uint64_t offset{0};
+		Callback callback;
+	};
+
+	explicit AsyncFileEngine(thread::ThreadPool& pool, unsigned queueDepth = DEFAULT_QUEUE_DEPTH);
+	AsyncFileEngine(const AsyncFileEngine&) = delete;
+	auto operator=(const AsyncFileEngine&) -> AsyncFileEngine& = delete;
+	~AsyncFileEngine();
+	[[nodiscard]] auto usesIoUring() const -> bool;
+	auto read(const FileDescriptor& fd, std::span<std::byte> buffer, uint64_t offset) -> std::future<size_t>;
+	auto write(const FileDescriptor& fd, std::span<const std::byte> buffer, uint64_t offset) -> std::future<size_t>;
+	auto read(const FileDescriptor& fd, std::span<std::byte> buffer, uint64_t offset, Callback callback) -> void;
+	auto write(const FileDescriptor& fd, std::span<const std::byte> buffer, uint64_t offset, Callback callback) -> void;
+	auto submit(std::vector<Request> requests) -> void;
+	auto registerBuffers(std::span<const std::span<std::byte>> buffers) -> void;
+	auto unregisterBuffers() -> void;
+
+private:
+	static constexpr unsigned DEFAULT_QUEUE_DEPTH = 64;
+
+	/// \brief The state of a request between submission and completion.
+	struct Pending
+	{
+		Operation operation;
+		int fd;
+		std::byte* data;
+		size_t size;
+		uint64_t offset;
+		size_t done{0};
+		int bufferIndex{-1};
+		Callback callback;
+	};
+
+	/// \brief The mapped io_uring rings.
+	struct Ring
+	{
+		int fd{-1};
+		unsigned entries{0};
+		void* sqRing{nullptr};
+		size_t sqRingSize{0};
+		void* cqRing{nullptr};
+		size_t cqRingSize{0};
+		void* sqes{nullptr};
+		size_t sqesSize{0};
+		std::atomic<unsigned>* sqHead{nullptr};
+		std::atomic<unsigned>* sqTail{nullptr};
+		unsigned sqMask{0};
+		unsigned* sqArray{nullptr};
+		std::atomic<unsigned>* cqHead{nullptr};
+		std::atomic<unsigned>* cqTail{nullptr};
+		unsigned cqMask{0};
+		void* cqes{nullptr};
+	};
+
+	static auto promiseCallback(std::shared_ptr<std::promise<size_t>> promise) -> Callback;
+	auto setupRing(unsigned queueDepth) -> bool;
+	auto teardownRing() -> void;
+	auto enqueue(std::unique_ptr<Pending> pending) -> void;
+	auto queueEntry(Pending& pending) -> void;
+	auto submitEntries() -> unsigned;
+	auto enter(unsigned toSubmit, unsigned minComplete, unsigned flags) const -> int;
+	auto reapLoop() -> void;
+	auto complete(Pending* pending, int result) -> void;
+	auto finish(std::unique_ptr<Pending> pending, std::exception_ptr error) -> void;
+	auto runFallback(std::unique_ptr<Pending> pending) -> void;
+	auto findRegisteredBuffer(const std::byte* data, size_t size) const -> int;
+	thread::ThreadPool& pool_;
+	Ring ring_;
+	bool ioUring_;
+	std::vector<std::span<std::byte>> registered_;
+	size_t inFlight_{0};
+	bool stop_{false};
+	std::mutex mutex_;
+	std::condition_variable room_;
+	std::thread reaper_;
+};
+}
@@ -0,0 +1,153 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#include "AsyncFileInputStream.hpp"
+// POSIX only, like AsyncFileEngine.
+#ifndef _WIN32
+#include <algorithm>
+#include <ios>
+#include <fcntl.h>
+
+namespace common::io
+{
+/// \brief Opens a file and starts reading its first blocks.
+/// \param engine The engine performing the reads; it must outlive the stream.
+/// \param file The file to read.
+/// \param blockSize The size of each read.
+/// \param depth The number of reads kept in flight.
+/// \throws std::invalid_argument if the block size or the depth is zero.
+/// \throws std::ios_base::failure if the file does not exist, is a directory or cannot be opened.
+AsyncFileInputStream::AsyncFileInputStream(AsyncFileEngine& engine, const std::filesystem::path& file, const size_t blockSize, const size_t depth) : engine_(engine), blockSize_(blockSize), depth_(depth) {
+	if (blockSize == 0 || depth == 0) {
+		throw std::invalid_argument("Block size and depth must be greater than zero");
+	}
+	if (!std::filesystem::exists(file)) {
+		throw std::ios_base::failure("FileNotFoundException: File does not exist.");
+	}
+	if (std::filesystem::is_directory(file)) {
+		throw std::ios_base::failure("FileNotFoundException: Path is a directory.");
+	}
+	fd_ = FileDescriptor(file, O_RDONLY);
+	size_ = fd_.size();
+	fd_.advise(FileDescriptor::Advice::Sequential);
+	readAhead();
+}
+
+AsyncFileInputStream::~AsyncFileInputStream() {
+	AsyncFileInputStream::close();
+}
+
+/// \brief Reads the next byte of data from this input stream.
+/// \return The next byte of data, or -1 if the end of the stream is reached.
+auto AsyncFileInputStream::read() -> std::byte {
+	std::byte byte;
+	if (consume(1, &byte) == 0) {
+		return static_cast<std::byte>(-1);
+	}
+	return byte;
+}
+
+/// \brief Reads up to buffer.size() bytes from the blocks read ahead, waiting for them as needed.
+/// \param buffer The memory into which the data is read.
+/// \return The number of bytes read, 0 at the end of the stream.
+/// \throws std::ios_base::failure if a read ahead failed.
+auto AsyncFileInputStream::read(const std::span<std::byte> buffer) -> size_t {
+	return consume(buffer.size(), buffer.data());
+}
+
+/// \brief Skips over and discards n bytes of data from this input stream.
+/// \return The number of bytes actually skipped.
+auto AsyncFileInputStream::skip(const size_t n) -> size_t {
+	return consume(n, nullptr);
+}
+
+/// \brief Returns the number of bytes left in the file.
+auto AsyncFileInputStream::available() -> size_t {
+	return size_ - position_;
+}
+
+/// \brief Waits for the reads in flight, whose buffers the engine still uses, and closes the file.
+auto AsyncFileInputStream::close() -> void {
+	for (Block& block : blocks_) {
+		if (block.pending.valid()) {
+			block.pending.wait();
+		}
+	}
+	blocks_.clear();
+	spare_.clear();
+	fd_.close();
+}
+
+/// \brief Tests if this input stream supports the mark and reset methods.
+/// \return false since blocks are discarded once drained.
+auto AsyncFileInputStream::markSupported() const -> bool {
+	return false;
+}
+
+/// \brief Issues reads until depth blocks are in flight or the whole file has been requested.
+auto AsyncFileInputStream::readAhead() -> void {
+	while (blocks_.size() < depth_ && nextOffset_ < size_) {
+		Block block;
+		if (spare_.empty()) {
+			block.data.resize(blockSize_);
+		}
+		else {
+			block.data = std::move(spare_.back());
+			spare_.pop_back();
+		}
+		const auto len = static_cast<size_t>(std::min<uint64_t>(blockSize_, size_ - nextOffset_));
+		// Moving the block into the deque keeps the vector's storage, so the span stays valid.
+		block.pending = engine_.read(fd_, std::span(block.data).first(len), nextOffset_);
+		nextOffset_ += len;
+		blocks_.push_back(std::move(block));
+	}
+}
+
+/// \brief Returns the oldest block that still has unread bytes, waiting for it to load, or nullptr at the end.
+auto AsyncFileInputStream::front() -> Block* {
+	while (!blocks_.empty()) {
+		Block& block = blocks_.front();
+		if (!block.loaded) {
+			try {
+				block.length = block.pending.get();
+			}
+			catch (...) {
+				blocks_.pop_front();
+				throw;
+			}
+			block.loaded = true;
+			if (block.length == 0) {
+				// The file was truncated since it was opened.
+				size_ = nextOffset_ = position_;
+			}
+		}
+		if (block.pos < block.length) {
+			return &block;
+		}
+		spare_.push_back(std::move(block.data));
+		blocks_.pop_front();
+		readAhead();
+	}
+	return nullptr;
+}
+
+/// \brief Takes up to n bytes from the blocks read ahead.
+/// \param n The number of bytes wanted.
+/// \param target Where to copy them, or nullptr to discard them.
+/// \return The number of bytes taken.
+auto AsyncFileInputStream::consume(const size_t n, std::byte* target) -> size_t {
+	size_t taken = 0;
+	while (taken < n) {
+		Block* block = front();
+		if (block == nullptr) break;
+		const size_t count = std::min(n - taken, block->length - block->pos);
+		if (target != nullptr) {
+			std::copy_n(block->data.begin() + static_cast<std::ptrdiff_t>(block->pos), count, target + taken);
+		}
+		block->pos += count;
+		taken += count;
+	}
+	position_ += taken;
+	return taken;
+}
+}
+#endif
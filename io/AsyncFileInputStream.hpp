@@ -0,0 +1,61 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <span>
+#include <vector>
+#include "AbstractInputStream.hpp"
+#include "AsyncFileEngine.hpp"
+#include "FileDescriptor.hpp"
+
+namespace common::io
+{
+/// \brief A class that reads a file through an AsyncFileEngine, keeping several blocks in flight ahead of the reader.
+/// \details Up to depth reads of blockSize bytes each are outstanding at any time, so the consumer normally
+/// finds the next block already loaded and only blocks when it outpaces the device. Block buffers are
+/// recycled as they are drained. The engine must outlive the stream.
+/// \remark POSIX only, like AsyncFileEngine.
+class AsyncFileInputStream final : public AbstractInputStream
+{
+public:
+	AsyncFileInputStream(AsyncFileEngine& engine, const std::filesystem::path& file, size_t blockSize = DEFAULT_BLOCK_SIZE, size_t depth = DEFAULT_DEPTH);
+	~AsyncFileInputStream() override;
+	using AbstractInputStream::read;
+	auto read() -> std::byte override;
+	auto read(std::span<std::byte> buffer) -> size_t override;
+	auto skip(size_t n) -> size_t override;
+	[[nodiscard]] auto available() -> size_t override;
+	auto close() -> void override;
+	[[nodiscard]] auto markSupported() const -> bool override;
+
+private:
+	static constexpr size_t DEFAULT_BLOCK_SIZE = 256 * 1024;
+	static constexpr size_t DEFAULT_DEPTH = 4;
+
+	/// \brief A block read ahead of the consumer.
+	struct Block
+	{
+		std::vector<std::byte> data;
+		std::future<size_t> pending;
+		size_t length{0};
+		size_t pos{0};
+		bool loaded{false};
+	};
+
+	auto readAhead() -> void;
+	auto front() -> Block*;
+	auto consume(size_t n, std::byte* target) -> size_t;
+	AsyncFileEngine& engine_;
+	FileDescriptor fd_;
+	uint64_t size_;
+	uint64_t position_{0};
+	uint64_t nextOffset_{0};
+	size_t blockSize_;
+	size_t depth_;
+	std::deque<Block> blocks_;
+	std::vector<std::vector<std::byte>> spare_;
+};
+}
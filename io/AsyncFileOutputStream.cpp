@@ -0,0 +1,130 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#include "AsyncFileOutputStream.hpp"
+// POSIX only, like AsyncFileEngine.
+#ifndef _WIN32
+#include <algorithm>
+#include <exception>
+#include <ios>
+#include <fcntl.h>
+
+namespace common::io
+{
+/// \brief Opens a file for writing, creating it if needed.
+/// \param engine The engine performing the writes; it must outlive the stream.
+/// \param file The file to write.
+/// \param append Whether to append to the existing content rather than truncate it.
+/// \param blockSize The size of each write.
+/// \param depth The number of writes kept in flight.
+/// \throws std::invalid_argument if the block size or the depth is zero.
+/// \throws std::ios_base::failure if the path is a directory or the file cannot be opened.
+AsyncFileOutputStream::AsyncFileOutputStream(AsyncFileEngine& engine, const std::filesystem::path& file, const bool append, const size_t blockSize, const size_t depth) : engine_(engine), offset_(0), blockSize_(blockSize), depth_(depth) {
+	if (blockSize == 0 || depth == 0) {
+		throw std::invalid_argument("Block size and depth must be greater than zero");
+	}
+	if (std::filesystem::exists(file) && std::filesystem::is_directory(file)) {
+		throw std::ios_base::failure("FileNotFoundException: Path is a directory.");
+	}
+	// Positional writes ignore the offset under O_APPEND on Linux, so appending starts at the current size instead.
+	fd_ = FileDescriptor(file, O_WRONLY | O_CREAT | (append ? 0 : O_TRUNC));
+	offset_ = append ? fd_.size() : 0;
+	current_.reserve(blockSize_);
+}
+
+AsyncFileOutputStream::~AsyncFileOutputStream() {
+	try {
+		AsyncFileOutputStream::close();
+	}
+	catch (...) {
+		// Suppress exceptions in destructors
+	}
+}
+
+/// \brief Writes a single byte.
+/// \param b The byte to be written.
+auto AsyncFileOutputStream::write(const std::byte b) -> void {
+	if (current_.size() == blockSize_) {
+		submitCurrent();
+	}
+	current_.push_back(b);
+}
+
+/// \brief Writes a block of memory.
+/// \details The bytes are copied into blocks; every block that fills up is submitted right away.
+/// \param buffer The bytes to be written.
+/// \throws std::ios_base::failure if an earlier write failed.
+auto AsyncFileOutputStream::write(const std::span<const std::byte> buffer) -> void {
+	size_t written = 0;
+	while (written < buffer.size()) {
+		if (current_.size() == blockSize_) {
+			submitCurrent();
+		}
+		const size_t count = std::min(buffer.size() - written, blockSize_ - current_.size());
+		current_.insert(current_.end(), buffer.begin() + static_cast<std::ptrdiff_t>(written), buffer.begin() + static_cast<std::ptrdiff_t>(written + count));
+		written += count;
+	}
+}
+
+/// \brief Submits the partial block and waits until every write has completed.
+/// \throws std::ios_base::failure if a write failed.
+auto AsyncFileOutputStream::flush() -> void {
+	submitCurrent();
+	while (!inFlight_.empty()) {
+		waitOldest();
+	}
+}
+
+/// \brief Flushes and closes the file. Closing a closed stream has no effect.
+/// \details The file is closed even if flushing fails; the failure is rethrown afterwards.
+auto AsyncFileOutputStream::close() -> void {
+	if (!fd_.isOpen()) return;
+	std::exception_ptr error;
+	try {
+		flush();
+	}
+	catch (...) {
+		error = std::current_exception();
+		for (Block& block : inFlight_) {
+			block.pending.wait();
+		}
+		inFlight_.clear();
+	}
+	fd_.close();
+	if (error) {
+		std::rethrow_exception(error);
+	}
+}
+
+/// \brief Submits the block being filled and starts a new one, first waiting for room if depth writes are in flight.
+auto AsyncFileOutputStream::submitCurrent() -> void {
+	if (current_.empty()) return;
+	if (inFlight_.size() >= depth_) {
+		waitOldest();
+	}
+	Block block;
+	block.data = std::move(current_);
+	// Moving the block into the deque keeps the vector's storage, so the span stays valid.
+	block.pending = engine_.write(fd_, std::span<const std::byte>(block.data), offset_);
+	offset_ += block.data.size();
+	inFlight_.push_back(std::move(block));
+	if (spare_.empty()) {
+		current_ = std::vector<std::byte>();
+		current_.reserve(blockSize_);
+	}
+	else {
+		current_ = std::move(spare_.back());
+		spare_.pop_back();
+		current_.clear();
+	}
+}
+
+/// \brief Waits for the oldest write in flight and recycles its buffer.
+/// \throws std::ios_base::failure if the write failed.
+auto AsyncFileOutputStream::waitOldest() -> void {
+	Block block = std::move(inFlight_.front());
+	inFlight_.pop_front();
+	block.pending.get();
+	spare_.push_back(std::move(block.data));
+}
+}
+#endif
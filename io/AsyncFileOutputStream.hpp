@@ -0,0 +1,55 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <span>
+#include <vector>
+#include "AbstractOutputStream.hpp"
+#include "AsyncFileEngine.hpp"
+#include "FileDescriptor.hpp"
+
+namespace common::io
+{
+/// \brief A class that writes a file through an AsyncFileEngine, letting several blocks be written behind the writer.
+/// \details Written bytes are gathered into blocks of blockSize bytes; each full block is submitted as one
+/// positional write and the writer carries on with the next block while up to depth writes are in flight.
+/// Write errors surface from the next write that has to wait for a block, from flush or from close.
+/// The engine must outlive the stream.
+/// \remark POSIX only, like AsyncFileEngine.
+class AsyncFileOutputStream final : public AbstractOutputStream
+{
+public:
+	AsyncFileOutputStream(AsyncFileEngine& engine, const std::filesystem::path& file, bool append = false, size_t blockSize = DEFAULT_BLOCK_SIZE, size_t depth = DEFAULT_DEPTH);
+	~AsyncFileOutputStream() override;
+	using AbstractOutputStream::write;
+	auto write(std::byte b) -> void override;
+	auto write(std::span<const std::byte> buffer) -> void override;
+	auto flush() -> void override;
+	auto close() -> void override;
+
+private:
+	static constexpr size_t DEFAULT_BLOCK_SIZE = 256 * 1024;
+	static constexpr size_t DEFAULT_DEPTH = 4;
+
+	/// \brief A block being written.
+	struct Block
+	{
+		std::vector<std::byte> data;
+		std::future<size_t> pending;
+	};
+
+	auto submitCurrent() -> void;
+	auto waitOldest() -> void;
+	AsyncFileEngine& engine_;
+	FileDescriptor fd_;
+	uint64_t offset_;
+	size_t blockSize_;
+	size_t depth_;
+	std::vector<std::byte> current_;
+	std::deque<Block> inFlight_;
+	std::vector<std::vector<std::byte>> spare_;
+};
+}
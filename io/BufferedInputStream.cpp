@@ -1,12 +1,13 @@
 // Created by author ethereal on 2024/12/7.
 // Copyright (c) 2024 ethereal. All rights reserved.
 #include "BufferedInputStream.hpp"
+#include <bit>
 
 namespace common::io
 {
 BufferedInputStream::BufferedInputStream(std::unique_ptr<AbstractInputStream> in): BufferedInputStream(std::move(in), DEFAULT_BUFFER_SIZE) {}
 
-BufferedInputStream::BufferedInputStream(std::unique_ptr<AbstractInputStream> in, const int size): FilterInputStream(std::move(in)), buf_(size) {
+BufferedInputStream::BufferedInputStream(std::unique_ptr<AbstractInputStream> in, const int size): FilterInputStream(std::move(in)), buf_(size), minBufferSize_(size) {
 	if (!&inputStream_) {
 		throw std::invalid_argument("Input stream cannot be null");
 	}
@@ -62,22 +63,28 @@ auto BufferedInputStream::read() -> std::byte {
 	return buf_[pos_++];
 }
 
-/// \brief Reads a portion of the stream into a byte array.
-/// \details This function reads up to len bytes of data from the input stream into a byte array buffer.
-/// The data is written to the buffer starting at offset, and the number of bytes read is returned.
+/// \brief Reads a portion of the stream into the given memory.
+/// \details This function reads up to buffer.size() bytes of data from the input stream into the buffer
+/// and returns the number of bytes read.
 /// If the end of the stream is reached before a byte could be read, or if an I/O error occurs, then -1 is returned.
-/// \param buffer The buffer to write the data to.
-/// \param offset The starting offset in the buffer.
-/// \param len The maximum number of bytes to read.
+/// Once the buffered bytes are used up, a remainder of at least a whole buffer is read directly into the
+/// given memory, unless a mark is active.
+/// \param buffer The memory to write the data to.
 /// \return The total number of bytes read into the buffer, or -1 if there is no more data because the end of the stream has been reached.
-auto BufferedInputStream::read(std::vector<std::byte>& buffer, size_t offset, size_t len) -> size_t {
-	if (offset + len > static_cast<int>(buffer.size())) {
-		throw std::out_of_range("Buffer offset/length out of range");
+auto BufferedInputStream::read(const std::span<std::byte> buffer) -> size_t {
+	if (adaptive_ && buffer.size() < buf_.size()) {
+		averageRequest_ = averageRequest_ - averageRequest_ / 8 + buffer.size() / 8;
 	}
+	size_t offset = 0;
+	size_t len = buffer.size();
 	size_t totalBytesRead = 0;
 	while (len > 0) {
 		size_t bytesAvailable = count_ - pos_;
 		if (bytesAvailable <= 0) {
+			if (len >= buf_.size() && !markActive()) {
+				totalBytesRead += readDirect(buffer.subspan(offset));
+				break;
+			}
 			fillBuffer();
 			bytesAvailable = count_ - pos_;
 			if (bytesAvailable <= 0) {
@@ -130,6 +137,23 @@ auto BufferedInputStream::skip(size_t n) -> size_t {
 	return skipped;
 }
 
+/// \brief Enables or disables adaptive sizing of the buffer.
+/// \details When enabled, the buffer is resized on refills to about four times the average size of the
+/// reads it serves, between the size given at construction and MAX_ADAPTIVE_BUFFER_SIZE. Disabling it
+/// keeps the current size.
+/// \param enabled Whether the buffer should adapt.
+auto BufferedInputStream::setAdaptiveSizing(const bool enabled) -> void {
+	adaptive_ = enabled;
+	averageRequest_ = buf_.size() / 4;
+}
+
+/// \brief Returns the counters of this stream.
+auto BufferedInputStream::getStats() const -> Stats {
+	Stats stats = stats_;
+	stats.bufferSize = buf_.size();
+	return stats;
+}
+
 /// \brief Fills the internal buffer with data from the underlying input stream.
 /// \details This method reads data from the underlying input stream into the internal buffer.
 /// If a mark has been set, it will be cleared if the buffer is filled in such a way that the
@@ -138,12 +162,60 @@ auto BufferedInputStream::fillBuffer() -> void {
 	if (markPos_ < 0 || pos_ - markPos_ >= markLimit_) {
 		markPos_ = -1;
 	}
-	if (const size_t bytesRead = inputStream_->read(buf_); bytesRead > 0) {
+	if (adaptive_ && !buf_.empty()) {
+		adaptBufferSize();
+	}
+	if (const size_t bytesRead = inputStream_->read(buf_); bytesRead > 0 && bytesRead != static_cast<size_t>(-1)) {
 		pos_ = 0;
 		count_ = bytesRead;
+		++stats_.bufferFills;
+		stats_.bytesBuffered += bytesRead;
 	}
 	else {
+		pos_ = 0;
 		count_ = 0;
 	}
 }
+
+/// \brief Reads from the underlying stream straight into the caller's memory, bypassing the buffer.
+/// \param buffer The memory to fill.
+/// \return The number of bytes read, less than requested only at the end of the stream.
+auto BufferedInputStream::readDirect(const std::span<std::byte> buffer) -> size_t {
+	size_t done = 0;
+	while (done < buffer.size()) {
+		const size_t bytesRead = inputStream_->read(buffer.subspan(done));
+		if (bytesRead == 0 || bytesRead == static_cast<size_t>(-1)) {
+			break;
+		}
+		done += bytesRead;
+		++stats_.passThroughReads;
+	}
+	stats_.bytesPassedThrough += done;
+	return done;
+}
+
+/// \brief Resizes the empty buffer towards four times the average buffered read.
+/// \details The buffer doubles while reads average more than a quarter of it, as each refill then serves
+/// only a handful of reads, and halves again, down to the initial size, once they average less than a
+/// sixteenth. The hysteresis keeps a mixed workload from resizing on every refill.
+auto BufferedInputStream::adaptBufferSize() -> void {
+	const size_t size = buf_.size();
+	size_t target = size;
+	if (averageRequest_ > size / 4 && size < MAX_ADAPTIVE_BUFFER_SIZE) {
+		target = std::min(MAX_ADAPTIVE_BUFFER_SIZE, std::bit_ceil(averageRequest_ * 4));
+	}
+	else if (averageRequest_ < size / 16 && size / 2 >= minBufferSize_) {
+		target = size / 2;
+	}
+	if (target != size) {
+		buf_.resize(target);
+		buf_.shrink_to_fit();
+		++stats_.bufferResizes;
+	}
+}
+
+/// \brief Tests whether a mark is set and still within its read limit, so the buffer must not be bypassed.
+auto BufferedInputStream::markActive() const -> bool {
+	return markPos_ != static_cast<size_t>(-1) && markLimit_ > 0 && pos_ - markPos_ < markLimit_;
+}
 }
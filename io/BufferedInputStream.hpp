@@ -1,6 +1,7 @@
 // Created by author ethereal on 2024/12/7.
 // Copyright (c) 2024 ethereal. All rights reserved.
 #pragma once
+#include <cstdint>
 #include <vector>
 #include "FilterInputStream.hpp"
 
@@ -10,27 +11,54 @@ namespace common::io
 /// \details It reads characters from a stream with buffering. The read and skip methods are supported.
 /// The available and markSupported methods are also supported.
 /// \remark The buffer size can be specified in the constructor.
+///
+/// Reads of at least a whole buffer bypass the buffer and go straight from the underlying stream into the
+/// caller's memory, saving a copy and the refills, unless a mark is active. With adaptive sizing enabled
+/// the buffer follows the size of the reads it serves, so a stream read in large pieces needs fewer
+/// refills. getStats() exposes the counters needed to tune both.
 class BufferedInputStream final : public FilterInputStream
 {
 public:
+	/// \brief Cumulative counters of a BufferedInputStream, for tuning its buffer size.
+	struct Stats
+	{
+		uint64_t bufferFills{0};
+		uint64_t bytesBuffered{0};
+		uint64_t passThroughReads{0};
+		uint64_t bytesPassedThrough{0};
+		uint64_t bufferResizes{0};
+		size_t bufferSize{0};
+	};
+
 	explicit BufferedInputStream(std::unique_ptr<AbstractInputStream> in);
 	BufferedInputStream(std::unique_ptr<AbstractInputStream> in, int size);
 	[[nodiscard]] auto available() const -> size_t;
 	auto close() -> void override;
 	auto mark(int readLimit) -> void override;
 	[[nodiscard]] auto markSupported() const -> bool override;
+	using FilterInputStream::read;
 	auto read() -> std::byte override;
-	auto read(std::vector<std::byte>& buffer, size_t offset, size_t len) -> size_t override;
+	auto read(std::span<std::byte> buffer) -> size_t override;
 	auto reset() -> void override;
 	auto skip(size_t n) -> size_t override;
+	auto setAdaptiveSizing(bool enabled) -> void;
+	[[nodiscard]] auto getStats() const -> Stats;
 
 protected:
 	static constexpr size_t DEFAULT_BUFFER_SIZE = 8192;
+	static constexpr size_t MAX_ADAPTIVE_BUFFER_SIZE = 1 << 20;
 	std::vector<std::byte> buf_;
 	size_t count_{0};
 	size_t markLimit_{0};
 	size_t markPos_{0};
 	size_t pos_{0};
+	size_t minBufferSize_{0};
+	size_t averageRequest_{0};
+	bool adaptive_{false};
+	Stats stats_;
 	auto fillBuffer() -> void;
+	auto readDirect(std::span<std::byte> buffer) -> size_t;
+	auto adaptBufferSize() -> void;
+	[[nodiscard]] auto markActive() const -> bool;
 };
 }
@@ -34,22 +34,18 @@ auto BufferedOutputStream::write(const std::byte b) -> void {
 	buffer_[bufferPosition_++] = b;
 }
 
-/// \brief Writes a portion of a byte array to the stream.
-/// \details This function writes a portion of a byte array to the output stream. If the buffer is full, it is flushed first.
-/// \param data The byte array to be written.
-/// \param offset The starting offset in the byte array.
-/// \param len The number of bytes to write.
-auto BufferedOutputStream::write(const std::vector<std::byte>& data, const size_t offset, const size_t len) -> void {
-	if (offset + len > data.size()) {
-		throw std::out_of_range("Data offset/length out of range");
-	}
+/// \brief Writes a block of memory to the stream.
+/// \details This function copies the data into the internal buffer, flushing it whenever it is full.
+/// \param data The bytes to be written.
+auto BufferedOutputStream::write(const std::span<const std::byte> data) -> void {
+	const size_t len = data.size();
 	size_t bytesWritten = 0;
 	while (bytesWritten < len) {
 		if (bufferPosition_ == bufferSize_) {
 			flushBuffer();
 		}
 		const size_t bytesToCopy = std::min(len - bytesWritten, bufferSize_ - bufferPosition_);
-		std::memcpy(&buffer_[bufferPosition_], &data[offset + bytesWritten], bytesToCopy);
+		std::memcpy(&buffer_[bufferPosition_], &data[bytesWritten], bytesToCopy);
 		bufferPosition_ += bytesToCopy;
 		bytesWritten += bytesToCopy;
 	}
@@ -73,7 +69,7 @@ auto BufferedOutputStream::close() -> void {
 /// It is a no-op if the buffer is empty.
 auto BufferedOutputStream::flushBuffer() -> void {
 	if (bufferPosition_ > 0) {
-		outputStream_->write(buffer_, 0, bufferPosition_);
+		outputStream_->write(std::span<const std::byte>(buffer_.data(), bufferPosition_));
 		bufferPosition_ = 0;
 	}
 }
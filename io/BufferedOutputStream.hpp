@@ -20,8 +20,9 @@ public:
 	explicit BufferedOutputStream(std::unique_ptr<AbstractOutputStream> out);
 	BufferedOutputStream(std::unique_ptr<AbstractOutputStream> out, size_t size);
 	~BufferedOutputStream() override;
+	using FilterOutputStream::write;
 	auto write(std::byte b) -> void override;
-	auto write(const std::vector<std::byte>& data, size_t offset, size_t len) -> void override;
+	auto write(std::span<const std::byte> data) -> void override;
 	auto flush() -> void override;
 	auto close() -> void override;
 
@@ -1,6 +1,9 @@
 // Created by author ethereal on 2024/12/8.
 // Copyright (c) 2024 ethereal. All rights reserved.
 #include "BufferedReader.hpp"
+#include "ScanUtil.hpp"
+#include <bit>
+#include <cstdint>
 
 namespace common::io
 {
@@ -102,6 +105,8 @@ auto BufferedReader::read(std::vector<char>& cBuf, size_t off, size_t len) -> si
 /// \brief Reads a line of text from the stream.
 /// \details Reads a line of text from the stream and returns it as a string.
 /// The line is read until the end of line is reached or a maximum number of characters is read.
+/// The newline is located with a vectorized scan (see ScanUtil) and the characters before it are appended
+/// in one run per buffer rather than one at a time. Carriage returns are dropped from the line.
 /// \return The line of text that was read from the stream.
 auto BufferedReader::readLine() -> std::string {
 	std::string line;
@@ -111,17 +116,67 @@ auto BufferedReader::readLine() -> std::string {
 				break;
 			}
 		}
-		const char ch = buffer_[pos_++];
-		if (ch == '\n') {
+		const char* begin = buffer_.data() + pos_;
+		const char* end = buffer_.data() + count_;
+		const char* newline = ScanUtil::find(begin, end, '\n');
+		line.append(begin, newline);
+		pos_ = static_cast<size_t>(newline - buffer_.data());
+		if (newline != end) {
+			++pos_;
 			break;
 		}
-		if (ch != '\r') {
-			line += ch;
-		}
+	}
+	if (ScanUtil::contains(line.data(), line.data() + line.size(), '\r')) {
+		std::erase(line, '\r');
 	}
 	return line;
 }
 
+/// \brief Reads a line of text without copying it.
+/// \details Works like readLine(), but when the whole line lies in the current buffer the returned view
+/// points straight into the buffer and no allocation or copy takes place. Only a line that straddles a
+/// refill is assembled in an internal string, which is reused from call to call. The view stays valid
+/// until the next operation on this reader.
+/// \return The line without its terminator, or std::nullopt once the end of the stream is reached.
+auto BufferedReader::readLineView() -> std::optional<std::string_view> {
+	return readRecord(Delimiter::Newline);
+}
+
+/// \brief Reads the next record without copying it.
+/// \details The record is returned as a view into the buffer when it lies in it completely; a record that
+/// straddles a refill is assembled in an internal string reused from call to call. Each time that happens
+/// the buffer is grown for the next refill, up to MAX_ADAPTIVE_BUFFER_SIZE, so streams of long records
+/// settle on a buffer large enough to be served without stitching. The view stays valid until the next
+/// operation on this reader.
+/// \param delimiter How records are separated.
+/// \return The record without its delimiter or length prefix, or std::nullopt once the end of the stream
+/// is reached.
+/// \throws std::ios_base::failure If a length-prefixed record is cut short by the end of the stream.
+auto BufferedReader::readRecord(const Delimiter delimiter) -> std::optional<std::string_view> {
+	switch (delimiter) {
+		case Delimiter::Newline: {
+			const auto line = readDelimited('\n');
+			return line ? std::optional(stripCarriageReturns(*line)) : std::nullopt;
+		}
+		case Delimiter::Nul: return readDelimited('\0');
+		case Delimiter::LengthPrefixed: return readLengthPrefixed();
+	}
+	return std::nullopt;
+}
+
+/// \brief Returns a lazy range over the lines of this reader, for use in a range-based for loop.
+/// \details The lines are produced by readLineView(), so iterating allocates nothing for lines that fit
+/// in the buffer.
+auto BufferedReader::lines() -> RecordRange {
+	return records(Delimiter::Newline);
+}
+
+/// \brief Returns a lazy range over the records of this reader.
+/// \param delimiter How records are separated.
+auto BufferedReader::records(const Delimiter delimiter) -> RecordRange {
+	return {*this, delimiter};
+}
+
 /// \brief Tests if this reader is ready to be read.
 /// \details Whether this reader is ready to be read. A reader is ready if the next read operation
 /// will not block. This reader is always ready because it is backed by an underlying reader in memory.
@@ -158,8 +213,144 @@ auto BufferedReader::skip(const long n) -> long {
 /// The buffer is filled starting from the beginning, and the function updates the buffer's count.
 /// \return true if the buffer was successfully filled with data, false otherwise (indicating EOF).
 bool BufferedReader::fillBuffer() {
+	if (targetSize_ > bufferSize_) {
+		bufferSize_ = targetSize_;
+		buffer_.resize(bufferSize_);
+	}
 	pos_ = 0;
 	count_ = reader_->read(buffer_, 0, bufferSize_);
+	if (count_ == static_cast<size_t>(-1)) {
+		count_ = 0;
+	}
 	return count_ > 0;
 }
+
+/// \brief Removes the carriage returns from a line, as readLine() does.
+/// \details The common case of no carriage return or a single trailing one (CRLF line endings) only
+/// shortens the view. Carriage returns inside the line are removed from a copy kept in line_.
+/// \param line The line, pointing into buffer_ or line_.
+/// \return The line without carriage returns.
+auto BufferedReader::stripCarriageReturns(std::string_view line) -> std::string_view {
+	if (!line.empty() && line.back() == '\r') {
+		line.remove_suffix(1);
+	}
+	if (!ScanUtil::contains(line.data(), line.data() + line.size(), '\r')) {
+		return line;
+	}
+	if (line.data() != line_.data()) {
+		line_.assign(line);
+	}
+	else {
+		line_.resize(line.size());
+	}
+	std::erase(line_, '\r');
+	return line_;
+}
+
+/// \brief Reads up to the next occurrence of a delimiter, stitching across refills when needed.
+/// \param delimiter The character that ends a record.
+/// \return The record without its delimiter, or std::nullopt at the end of the stream.
+auto BufferedReader::readDelimited(const char delimiter) -> std::optional<std::string_view> {
+	if (pos_ >= count_) {
+		if (!fillBuffer()) {
+			return std::nullopt;
+		}
+	}
+	const char* begin = buffer_.data() + pos_;
+	const char* end = buffer_.data() + count_;
+	const char* found = ScanUtil::find(begin, end, delimiter);
+	if (found != end) {
+		pos_ = static_cast<size_t>(found - buffer_.data()) + 1;
+		return std::string_view(begin, found);
+	}
+	line_.assign(begin, end);
+	pos_ = count_;
+	while (fillBuffer()) {
+		begin = buffer_.data();
+		end = begin + count_;
+		found = ScanUtil::find(begin, end, delimiter);
+		line_.append(begin, found);
+		pos_ = static_cast<size_t>(found - begin);
+		if (found != end) {
+			++pos_;
+			break;
+		}
+	}
+	growFor(line_.size());
+	return line_;
+}
+
+/// \brief Reads a record preceded by its 32-bit little-endian length.
+/// \return The record, or std::nullopt if the stream ends before a new length prefix.
+/// \throws std::ios_base::failure If the stream ends inside the prefix or the record.
+auto BufferedReader::readLengthPrefixed() -> std::optional<std::string_view> {
+	uint32_t length = 0;
+	for (int i = 0; i < 4; ++i) {
+		if (pos_ >= count_) {
+			if (!fillBuffer()) {
+				if (i == 0) {
+					return std::nullopt;
+				}
+				throw std::ios_base::failure("IOException: Truncated record length.");
+			}
+		}
+		length |= static_cast<uint32_t>(static_cast<unsigned char>(buffer_[pos_++])) << (8 * i);
+	}
+	if (count_ - pos_ >= length) {
+		const std::string_view record(buffer_.data() + pos_, length);
+		pos_ += length;
+		return record;
+	}
+	line_.assign(buffer_.data() + pos_, buffer_.data() + count_);
+	pos_ = count_;
+	while (line_.size() < length) {
+		if (!fillBuffer()) {
+			throw std::ios_base::failure("IOException: Truncated record.");
+		}
+		const size_t take = std::min<size_t>(length - line_.size(), count_);
+		line_.append(buffer_.data(), take);
+		pos_ = take;
+	}
+	growFor(line_.size());
+	return line_;
+}
+
+/// \brief Plans a larger buffer after a record of the given size had to be stitched across refills.
+/// \details The buffer is resized by the next fillBuffer(), when it holds no unread data, to the next
+/// power of two that fits two such records.
+auto BufferedReader::growFor(const size_t recordSize) -> void {
+	if (recordSize >= MAX_ADAPTIVE_BUFFER_SIZE / 2) {
+		targetSize_ = MAX_ADAPTIVE_BUFFER_SIZE;
+	}
+	else {
+		targetSize_ = std::max(targetSize_, std::bit_ceil(2 * recordSize));
+	}
+}
+
+BufferedReader::RecordRange::RecordRange(BufferedReader& reader, const Delimiter delimiter) : reader_(reader), delimiter_(delimiter) {}
+
+/// \brief Reads the first record and returns an iterator positioned on it.
+auto BufferedReader::RecordRange::begin() -> Iterator {
+	return {reader_, delimiter_};
+}
+
+auto BufferedReader::RecordRange::end() const -> std::default_sentinel_t {
+	return std::default_sentinel;
+}
+
+BufferedReader::RecordRange::Iterator::Iterator(BufferedReader& reader, const Delimiter delimiter) : reader_(&reader), delimiter_(delimiter), current_(reader.readRecord(delimiter)) {}
+
+auto BufferedReader::RecordRange::Iterator::operator*() const -> std::string_view {
+	return *current_;
+}
+
+/// \brief Reads the next record; the view of the previous one becomes invalid.
+auto BufferedReader::RecordRange::Iterator::operator++() -> Iterator& {
+	current_ = reader_->readRecord(delimiter_);
+	return *this;
+}
+
+auto BufferedReader::RecordRange::Iterator::operator++(int) -> void {
+	++*this;
+}
 }
@@ -1,7 +1,12 @@
 // Created by author ethereal on 2024/12/8.
 // Copyright (c) 2024 ethereal. All rights reserved.
 #pragma once
+#include <cstddef>
 #include <iostream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
 #include "AbstractReader.hpp"
 
 namespace common::io
@@ -10,9 +15,64 @@ namespace common::io
 /// \details This class provides buffering for a Reader object. Buffering can greatly improve performance by reducing the number
 /// of calls to the underlying Reader object. The buffering is optional and can be disabled by calling the constructor with
 /// a buffer size of 0.
+///
+/// Lines and other records can be read without copying through readLineView(), readRecord() and the lazy
+/// ranges returned by lines() and records(), e.g. `for (std::string_view line : reader.lines())`.
 class BufferedReader final : public AbstractReader
 {
 public:
+	/// \brief How records are separated in the stream.
+	enum class Delimiter
+	{
+		/// \brief Records end with '\n'; carriage returns are dropped, as in readLine().
+		Newline,
+		/// \brief Records end with '\0'.
+		Nul,
+		/// \brief Every record is preceded by its length as a 32-bit little-endian unsigned integer.
+		LengthPrefixed
+	};
+
+	/// \brief A lazy, single-pass range over the records of a reader.
+	/// \details Each element is a view that stays valid until the iterator is advanced or the reader is
+	/// used otherwise. Iterating consumes the reader; the range is meant for a single range-based for loop.
+	class RecordRange
+	{
+	public:
+		class Iterator
+		{
+		public:
+			using iterator_concept = std::input_iterator_tag;
+			using iterator_category = std::input_iterator_tag;
+			using value_type = std::string_view;
+			using difference_type = std::ptrdiff_t;
+			using reference = std::string_view;
+
+			Iterator() = default;
+			auto operator*() const -> std::string_view;
+			auto operator++() -> Iterator&;
+			auto operator++(int) -> void;
+			friend auto operator==(const Iterator& it, std::default_sentinel_t) -> bool {
+				return !it.current_.has_value();
+			}
+
+		private:
+			friend class RecordRange;
+			Iterator(BufferedReader& reader, Delimiter delimiter);
+			BufferedReader* reader_{nullptr};
+			Delimiter delimiter_{Delimiter::Newline};
+			std::optional<std::string_view> current_;
+		};
+
+		auto begin() -> Iterator;
+		[[nodiscard]] auto end() const -> std::default_sentinel_t;
+
+	private:
+		friend class BufferedReader;
+		RecordRange(BufferedReader& reader, Delimiter delimiter);
+		BufferedReader& reader_;
+		Delimiter delimiter_;
+	};
+
 	explicit BufferedReader(std::unique_ptr<AbstractReader> reader, int size);
 	~BufferedReader() override;
 	auto close() -> void override;
@@ -22,17 +82,28 @@ public:
 	auto read() -> int override;
 	auto read(std::vector<char>& cBuf, size_t off, size_t len) -> size_t override;
 	auto readLine() -> std::string;
+	auto readLineView() -> std::optional<std::string_view>;
+	auto readRecord(Delimiter delimiter) -> std::optional<std::string_view>;
+	auto lines() -> RecordRange;
+	auto records(Delimiter delimiter) -> RecordRange;
 	[[nodiscard]] auto ready() const -> bool override;
 	auto skip(long n) -> long;
 
 private:
 	static constexpr size_t DEFAULT_BUFFER_SIZE = 8192;
+	static constexpr size_t MAX_ADAPTIVE_BUFFER_SIZE = 1 << 20;
 	std::vector<char> buffer_;
 	std::unique_ptr<AbstractReader> reader_;
 	size_t bufferSize_{0};
 	size_t pos_{0};
 	size_t count_{0};
 	size_t markLimit_{0};
+	std::string line_;
+	size_t targetSize_{0};
 	bool fillBuffer();
+	auto readDelimited(char delimiter) -> std::optional<std::string_view>;
+	auto readLengthPrefixed() -> std::optional<std::string_view>;
+	auto stripCarriageReturns(std::string_view line) -> std::string_view;
+	auto growFor(size_t recordSize) -> void;
 };
 }
@@ -32,26 +32,17 @@ auto ByteArrayInputStream::skip(const size_t n) -> size_t {
 	return bytesToSkip;
 }
 
-/// \brief Reads bytes from the input stream into a specified buffer.
-/// \details This method reads up to len bytes from the input stream into the provided buffer vector, starting at the specified offset.
-/// It copies bytes from the internal buffer to the given buffer. If the end of the stream is reached before reading the requested number of bytes,
-/// it returns the actual number of bytes read. If the offset and length exceed the size of the buffer, an exception is thrown.
-/// \param cBuf The buffer into which the data is read.
-/// \param off The starting position in the buffer to write the data.
-/// \param len The maximum number of bytes to read into the buffer.
+/// \brief Reads bytes from the input stream into the specified memory.
+/// \details This method copies up to cBuf.size() bytes from the internal buffer straight into the given memory.
+/// If the end of the stream is reached before reading the requested number of bytes, it returns the actual number of bytes read.
+/// \param cBuf The memory into which the data is read.
 /// \return The total number of bytes read into the buffer, or 0 if the end of the stream has been reached.
-/// \throws std::out_of_range If the offset and length exceed the size of the buffer.
-auto ByteArrayInputStream::read(std::vector<std::byte>& cBuf, const size_t off, size_t len) -> size_t {
-	if (off + len > cBuf.size()) {
-		throw std::out_of_range("Offset and length exceed the size of the buffer");
-	}
-	if (const size_t remaining = buffer_.size() - pos_; len > remaining) {
-		len = remaining;
-	}
+auto ByteArrayInputStream::read(const std::span<std::byte> cBuf) -> size_t {
 	if (pos_ >= buffer_.size()) {
 		return 0;
 	}
-	std::copy_n(buffer_.begin() + static_cast<std::ptrdiff_t>(pos_), len, cBuf.begin() + static_cast<std::ptrdiff_t>(off));
+	const size_t len = std::min(cBuf.size(), buffer_.size() - pos_);
+	std::copy_n(buffer_.begin() + static_cast<std::ptrdiff_t>(pos_), len, cBuf.begin());
 	pos_ += len;
 	return len;
 }
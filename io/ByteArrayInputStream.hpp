@@ -13,9 +13,10 @@ class ByteArrayInputStream final : public AbstractInputStream
 {
 public:
 	explicit ByteArrayInputStream(const std::vector<std::byte>& buf);
+	using AbstractInputStream::read;
 	auto read() -> std::byte override;
 	auto skip(size_t n) -> size_t override;
-	auto read(std::vector<std::byte>& cBuf, size_t off, size_t len) -> size_t override;
+	auto read(std::span<std::byte> cBuf) -> size_t override;
 	[[nodiscard]] size_t available() override;
 	void reset() override;
 	void mark(size_t readAheadLimit);
@@ -23,21 +23,16 @@ auto ByteArrayOutputStream::write(const std::byte b) -> void {
 	buf_[count_++] = b;
 }
 
-/// \brief Writes a portion of a byte array to the buffer.
-/// \param buffer Data array to be written.
-/// \param offset Offset from which to start writing in the buffer.
-/// \param len Number of bytes to write from the buffer.
-/// \details This method writes \p len bytes from the specified \p buffer starting at \p offset to the internal byte buffer.
-/// If the internal buffer is full, it is resized to accommodate the new data. Throws an exception if the offset and length
-/// exceed the size of the input buffer.
-auto ByteArrayOutputStream::write(const std::vector<std::byte>& buffer, const size_t offset, const size_t len) -> void {
-	if (offset + len > buffer.size()) {
-		throw std::out_of_range("Buffer offset/length out of range");
-	}
+/// \brief Writes a block of memory to the buffer.
+/// \param buffer The bytes to be written.
+/// \details This method appends the bytes to the internal byte buffer.
+/// If the internal buffer is full, it is resized to accommodate the new data.
+auto ByteArrayOutputStream::write(const std::span<const std::byte> buffer) -> void {
+	const size_t len = buffer.size();
 	if (count_ + len > buf_.size()) {
 		buf_.resize(std::max(buf_.size() * 2, count_ + len));
 	}
-	std::copy_n(buffer.begin() + static_cast<std::vector<char>::difference_type>(offset), len, buf_.begin() + static_cast<std::vector<char>::difference_type>(count_));
+	std::copy_n(buffer.begin(), len, buf_.begin() + static_cast<std::vector<char>::difference_type>(count_));
 	count_ += len;
 }
 
@@ -45,7 +40,7 @@ auto ByteArrayOutputStream::write(const std::vector<std::byte>& buffer, const si
 /// \param out Stream to write to.
 /// \details This method writes the entire content of the internal buffer to the given OutputStream.
 auto ByteArrayOutputStream::writeTo(AbstractOutputStream& out) const -> void {
-	out.write(buf_, 0, count_);
+	out.write(std::span<const std::byte>(buf_.data(), count_));
 }
 
 /// \brief Resets the buffer to an empty state.
@@ -13,8 +13,9 @@ class ByteArrayOutputStream final : public AbstractOutputStream
 public:
 	ByteArrayOutputStream();
 	explicit ByteArrayOutputStream(size_t size);
+	using AbstractOutputStream::write;
 	auto write(std::byte b) -> void override;
-	auto write(const std::vector<std::byte>& buffer, size_t offset, size_t len) -> void override;
+	auto write(std::span<const std::byte> buffer) -> void override;
 	auto writeTo(AbstractOutputStream& out) const -> void;
 	auto reset() -> void;
 	[[nodiscard]] auto toByteArray() const -> std::vector<std::byte>;
@@ -0,0 +1,298 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#include "FileDescriptor.hpp"
+// POSIX only; on Windows FileInputStream and FileOutputStream take its place.
+#ifndef _WIN32
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <ios>
+#include <system_error>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace common::io
+{
+namespace
+{
+constexpr int64_t NO_OFFSET = -1;
+
+/// \brief Throws std::ios_base::failure with the current errno attached.
+[[noreturn]] auto throwErrno(const char* message) -> void {
+	throw std::ios_base::failure(message, std::error_code(errno, std::generic_category()));
+}
+
+/// \brief Builds the iovec array of a list of buffers, dropping empty ones.
+template <class Buffer> auto toIovecs(const std::span<const Buffer> buffers) -> std::vector<iovec> {
+	std::vector<iovec> iov;
+	iov.reserve(buffers.size());
+	for (const auto& buffer : buffers) {
+		if (!buffer.empty()) {
+			iov.push_back({const_cast<std::byte*>(buffer.data()), buffer.size()});
+		}
+	}
+	return iov;
+}
+
+/// \brief Moves bytes between a descriptor and a list of buffers.
+/// \param fd The descriptor.
+/// \param iov The buffers; consumed entries are modified.
+/// \param offset The file offset of the first byte, or NO_OFFSET to use and advance the descriptor's offset.
+/// \param writing Whether to write the buffers rather than read into them.
+/// \param fully Whether to keep going after a short read; writes always continue until done.
+/// \return The number of bytes transferred, less than requested only if a read reached end of file or
+/// returned early because fully was false.
+auto transfer(const int fd, std::vector<iovec>& iov, const int64_t offset, const bool writing, const bool fully) -> size_t {
+	size_t total = 0;
+	iovec* current = iov.data();
+	size_t count = iov.size();
+	while (count > 0) {
+		const int batch = static_cast<int>(std::min<size_t>(count, IOV_MAX));
+		ssize_t n;
+		if (writing) {
+			n = offset == NO_OFFSET ? ::writev(fd, current, batch) : ::pwritev(fd, current, batch, static_cast<off_t>(offset + total));
+		}
+		else {
+			n = offset == NO_OFFSET ? ::readv(fd, current, batch) : ::preadv(fd, current, batch, static_cast<off_t>(offset + total));
+		}
+		if (n < 0) {
+			if (errno == EINTR) continue;
+			throwErrno(writing ? "IOException: Write failed." : "IOException: Read failed.");
+		}
+		if (n == 0) {
+			if (writing) {
+				throw std::ios_base::failure("IOException: Write made no progress.");
+			}
+			break;
+		}
+		total += static_cast<size_t>(n);
+		auto left = static_cast<size_t>(n);
+		while (count > 0 && left >= current->iov_len) {
+			left -= current->iov_len;
+			++current;
+			--count;
+		}
+		if (left > 0) {
+			current->iov_base = static_cast<std::byte*>(current->iov_base) + left;
+			current->iov_len -= left;
+		}
+		if (!writing && !fully) break;
+	}
+	return total;
+}
+}
+
+/// \brief Takes ownership of an open descriptor.
+/// \param fd The descriptor, closed when this object is destroyed.
+FileDescriptor::FileDescriptor(const int fd) : fd_(fd) {}
+
+/// \brief Opens a file.
+/// \param file The file to open.
+/// \param flags The open(2) flags; O_CLOEXEC is always added.
+/// \param mode The permissions of a file created by O_CREAT.
+/// \throws std::ios_base::failure if the file cannot be opened.
+FileDescriptor::FileDescriptor(const std::filesystem::path& file, const int flags, const unsigned mode) {
+	do {
+		fd_ = ::open(file.c_str(), flags | O_CLOEXEC, static_cast<mode_t>(mode));
+	}
+	while (fd_ < 0 && errno == EINTR);
+	if (fd_ < 0) {
+		throwErrno("FileNotFoundException: Unable to open file.");
+	}
+}
+
+FileDescriptor::FileDescriptor(FileDescriptor&& other) noexcept : fd_(std::exchange(other.fd_, -1)) {}
+
+auto FileDescriptor::operator=(FileDescriptor&& other) noexcept -> FileDescriptor& {
+	if (this != &other) {
+		close();
+		fd_ = std::exchange(other.fd_, -1);
+	}
+	return *this;
+}
+
+FileDescriptor::~FileDescriptor() {
+	close();
+}
+
+/// \brief Returns the raw descriptor, or -1 once closed.
+auto FileDescriptor::get() const -> int {
+	return fd_;
+}
+
+/// \brief Tests whether the descriptor is open.
+auto FileDescriptor::isOpen() const -> bool {
+	return fd_ >= 0;
+}
+
+/// \brief Closes the descriptor. Closing a closed descriptor has no effect.
+auto FileDescriptor::close() -> void {
+	if (fd_ >= 0) {
+		::close(fd_);
+		fd_ = -1;
+	}
+}
+
+/// \brief Reads at the current offset with a single read call, like read(2).
+/// \param buffer The memory to read into.
+/// \return The number of bytes read, 0 at end of file.
+auto FileDescriptor::read(const std::span<std::byte> buffer) const -> size_t {
+	checkOpen();
+	std::vector<iovec> iov = toIovecs(std::span<const std::span<std::byte>>(&buffer, 1));
+	return transfer(fd_, iov, NO_OFFSET, false, false);
+}
+
+/// \brief Reads at a given offset until the buffer is full or end of file is reached.
+/// \param buffer The memory to read into.
+/// \param offset The file offset of the first byte.
+/// \return The number of bytes read.
+auto FileDescriptor::readAt(const std::span<std::byte> buffer, const uint64_t offset) const -> size_t {
+	return readAt(std::span<const std::span<std::byte>>(&buffer, 1), offset);
+}
+
+/// \brief Reads a contiguous range of the file into several buffers (scatter read).
+/// \param buffers The memory to read into, filled in order.
+/// \param offset The file offset of the first byte.
+/// \return The number of bytes read.
+auto FileDescriptor::readAt(const std::span<const std::span<std::byte>> buffers, const uint64_t offset) const -> size_t {
+	checkOpen();
+	std::vector<iovec> iov = toIovecs(buffers);
+	return transfer(fd_, iov, static_cast<int64_t>(offset), false, true);
+}
+
+/// \brief Writes a whole buffer at the current offset.
+auto FileDescriptor::write(const std::span<const std::byte> buffer) const -> void {
+	write(std::span<const std::span<const std::byte>>(&buffer, 1));
+}
+
+/// \brief Writes several buffers back to back at the current offset with as few calls as possible (gather write).
+auto FileDescriptor::write(const std::span<const std::span<const std::byte>> buffers) const -> void {
+	checkOpen();
+	std::vector<iovec> iov = toIovecs(buffers);
+	transfer(fd_, iov, NO_OFFSET, true, true);
+}
+
+/// \brief Writes a whole buffer at a given offset.
+auto FileDescriptor::writeAt(const std::span<const std::byte> buffer, const uint64_t offset) const -> void {
+	writeAt(std::span<const std::span<const std::byte>>(&buffer, 1), offset);
+}
+
+/// \brief Writes several buffers back to back starting at a given offset (gather write).
+auto FileDescriptor::writeAt(const std::span<const std::span<const std::byte>> buffers, const uint64_t offset) const -> void {
+	checkOpen();
+	std::vector<iovec> iov = toIovecs(buffers);
+	transfer(fd_, iov, static_cast<int64_t>(offset), true, true);
+}
+
+/// \brief Moves the file offset, see lseek(2).
+/// \return The new offset.
+auto FileDescriptor::seek(const int64_t offset, const int whence) const -> uint64_t {
+	checkOpen();
+	const off_t result = ::lseek(fd_, static_cast<off_t>(offset), whence);
+	if (result < 0) {
+		throwErrno("IOException: Seek failed.");
+	}
+	return static_cast<uint64_t>(result);
+}
+
+/// \brief Returns the size of the file.
+auto FileDescriptor::size() const -> uint64_t {
+	checkOpen();
+	struct stat status{};
+	if (::fstat(fd_, &status) != 0) {
+		throwErrno("IOException: Unable to query file size.");
+	}
+	return static_cast<uint64_t>(status.st_size);
+}
+
+/// \brief Tests whether the descriptor refers to a regular file rather than a pipe, socket or device.
+auto FileDescriptor::isRegularFile() const -> bool {
+	checkOpen();
+	struct stat status{};
+	return ::fstat(fd_, &status) == 0 && S_ISREG(status.st_mode);
+}
+
+/// \brief Tells the kernel how a range of the file is going to be accessed.
+/// \details WillNeed starts reading the range into the page cache in the background; DontNeed drops it,
+/// which is useful after streaming through data that will not be read again. The hint is advisory and
+/// silently ignored where unsupported.
+/// \param advice The hint.
+/// \param offset The start of the range.
+/// \param len The length of the range, 0 for up to the end of the file.
+auto FileDescriptor::advise(const Advice advice, const uint64_t offset, const uint64_t len) const -> void {
+	checkOpen();
+#if defined(POSIX_FADV_NORMAL)
+	int value = POSIX_FADV_NORMAL;
+	switch (advice) {
+		case Advice::Normal: value = POSIX_FADV_NORMAL;
+			break;
+		case Advice::Sequential: value = POSIX_FADV_SEQUENTIAL;
+			break;
+		case Advice::Random: value = POSIX_FADV_RANDOM;
+			break;
+		case Advice::WillNeed: value = POSIX_FADV_WILLNEED;
+			break;
+		case Advice::DontNeed: value = POSIX_FADV_DONTNEED;
+			break;
+	}
+	::posix_fadvise(fd_, static_cast<off_t>(offset), static_cast<off_t>(len), value);
+#endif
+}
+
+/// \brief Reserves disk space for a range of the file, extending it if needed.
+/// \details Preallocating before a large sequential write avoids fragmentation and turns later out-of-space
+/// conditions into an error here rather than in the middle of the write.
+/// \throws std::ios_base::failure if the space cannot be reserved.
+auto FileDescriptor::preallocate(const uint64_t offset, const uint64_t len) const -> void {
+	checkOpen();
+#if defined(__APPLE__)
+	// macOS has no posix_fallocate: reserve the blocks past the physical end of file, then extend the file.
+	const uint64_t end = offset + len;
+	const uint64_t current = size();
+	if (end <= current) return;
+	fstore_t store{F_ALLOCATECONTIG | F_ALLOCATEALL, F_PEOFPOSMODE, 0, static_cast<off_t>(end - current), 0};
+	if (::fcntl(fd_, F_PREALLOCATE, &store) != 0) {
+		store.fst_flags = F_ALLOCATEALL;
+		if (::fcntl(fd_, F_PREALLOCATE, &store) != 0) {
+			throwErrno("IOException: Unable to preallocate file.");
+		}
+	}
+	if (::ftruncate(fd_, static_cast<off_t>(end)) != 0) {
+		throwErrno("IOException: Unable to preallocate file.");
+	}
+#else
+	if (const int error = ::posix_fallocate(fd_, static_cast<off_t>(offset), static_cast<off_t>(len)); error != 0) {
+		errno = error;
+		throwErrno("IOException: Unable to preallocate file.");
+	}
+#endif
+}
+
+/// \brief Forces written data to the storage device, see fdatasync(2).
+/// \details macOS has no fdatasync; there F_FULLFSYNC is used, which also flushes the drive's cache, and
+/// fsync on file systems that do not support it.
+auto FileDescriptor::sync() const -> void {
+	checkOpen();
+#if defined(__APPLE__)
+	if (::fcntl(fd_, F_FULLFSYNC) != 0 && ::fsync(fd_) != 0) {
+		throwErrno("IOException: Sync failed.");
+	}
+#else
+	if (::fdatasync(fd_) != 0) {
+		throwErrno("IOException: Sync failed.");
+	}
+#endif
+}
+
+/// \brief Throws if the descriptor has been closed.
+auto FileDescriptor::checkOpen() const -> void {
+	if (fd_ < 0) {
+		throw std::ios_base::failure("IOException: Stream Closed");
+	}
+}
+}
+#endif
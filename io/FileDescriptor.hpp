@@ -0,0 +1,58 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+namespace common::io
+{
+/// \brief An owned POSIX file descriptor with the positional, vectored and advisory calls built on it.
+/// \details All transfers retry on EINTR and continue after short transfers, so a call either moves every
+/// byte asked for, stops at end of file, or throws std::ios_base::failure carrying errno. Positional calls
+/// (readAt, writeAt) neither use nor move the file offset and may be issued from several threads at once.
+/// Vectored calls are split into batches of at most IOV_MAX buffers.
+/// \remark POSIX only; the implementation is not compiled on Windows.
+class FileDescriptor final
+{
+public:
+	/// \brief An access pattern hint for a range of the file, see posix_fadvise.
+	enum class Advice
+	{
+		Normal,
+		Sequential,
+		Random,
+		WillNeed,
+		DontNeed
+	};
+
+	FileDescriptor() = default;
+	explicit FileDescriptor(int fd);
+	FileDescriptor(const std::filesystem::path& file, int flags, unsigned mode = 0644);
+	FileDescriptor(const FileDescriptor&) = delete;
+	auto operator=(const FileDescriptor&) -> FileDescriptor& = delete;
+	FileDescriptor(FileDescriptor&& other) noexcept;
+	auto operator=(FileDescriptor&& other) noexcept -> FileDescriptor&;
+	~FileDescriptor();
+	[[nodiscard]] auto get() const -> int;
+	[[nodiscard]] auto isOpen() const -> bool;
+	auto close() -> void;
+	auto read(std::span<std::byte> buffer) const -> size_t;
+	auto readAt(std::span<std::byte> buffer, uint64_t offset) const -> size_t;
+	auto readAt(std::span<const std::span<std::byte>> buffers, uint64_t offset) const -> size_t;
+	auto write(std::span<const std::byte> buffer) const -> void;
+	auto write(std::span<const std::span<const std::byte>> buffers) const -> void;
+	auto writeAt(std::span<const std::byte> buffer, uint64_t offset) const -> void;
+	auto writeAt(std::span<const std::span<const std::byte>> buffers, uint64_t offset) const -> void;
+	auto seek(int64_t offset, int whence) const -> uint64_t;
+	[[nodiscard]] auto size() const -> uint64_t;
+	[[nodiscard]] auto isRegularFile() const -> bool;
+	auto advise(Advice advice, uint64_t offset = 0, uint64_t len = 0) const -> void;
+	auto preallocate(uint64_t offset, uint64_t len) const -> void;
+	auto sync() const -> void;
+
+private:
+	auto checkOpen() const -> void;
+	int fd_{-1};
+};
+}
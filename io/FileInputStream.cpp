@@ -39,33 +39,15 @@ auto FileInputStream::read() -> std::byte {
 	return static_cast<std::byte>(-1);
 }
 
-/// \brief Reads bytes from this input stream into the specified byte array.
-/// \details This method reads up to b.length bytes from this input stream into the byte array b.
-/// The bytes are read into the byte array starting at offset 0.
+/// \brief Reads up to buffer.size() bytes of data from this input stream into the given memory.
+/// \details The file stream reads straight into the caller's memory.
 /// If no byte is available because the end of the stream has been reached, the number of bytes read is returned.
 /// Otherwise, the number of bytes actually read is returned.
 /// This method blocks until input data is available, the end of the stream is detected, or an exception is thrown.
-/// \param buffer the buffer into which the data is read.
-/// \return the total number of bytes read into the buffer, or -1 if there is no more data because the end of the stream has been reached.
-auto FileInputStream::read(std::vector<std::byte>& buffer) -> size_t {
-	return read(buffer, 0, buffer.size());
-}
-
-/// \brief Reads up to len bytes of data from this input stream into an array of bytes.
-/// \details This method reads up to len bytes from this input stream into the byte array b.
-/// The bytes are read into the byte array starting at offset.
-/// If no byte is available because the end of the stream has been reached, the number of bytes read is returned.
-/// Otherwise, the number of bytes actually read is returned.
-/// This method blocks until input data is available, the end of the stream is detected, or an exception is thrown.
-/// \param buffer the buffer into which the data is read.
-/// \param offset the starting offset in the buffer.
-/// \param len the maximum number of bytes to read.
-/// \return the total number of bytes read into the buffer, or -1 if there is no more data because the end of the stream has been reached.
-auto FileInputStream::read(std::vector<std::byte>& buffer, const size_t offset, const size_t len) -> size_t {
-	if (offset + len > buffer.size()) {
-		throw std::invalid_argument("Invalid buffer, offset, or length.");
-	}
-	fileStream_.read(reinterpret_cast<char*>(buffer.data() + offset), static_cast<std::streamsize>(len));
+/// \param buffer the memory into which the data is read.
+/// \return the total number of bytes read into the buffer.
+auto FileInputStream::read(const std::span<std::byte> buffer) -> size_t {
+	fileStream_.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
 	return fileStream_.gcount();
 }
 
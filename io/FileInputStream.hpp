@@ -22,9 +22,9 @@ public:
 	explicit FileInputStream(const char* name);
 	explicit FileInputStream(const std::filesystem::path& file);
 	~FileInputStream() override;
+	using AbstractInputStream::read;
 	auto read() -> std::byte override;
-	auto read(std::vector<std::byte>& buffer) -> size_t override;
-	auto read(std::vector<std::byte>& buffer, size_t offset, size_t len) -> size_t override;
+	auto read(std::span<std::byte> buffer) -> size_t override;
 	auto skip(size_t n) -> size_t override;
 	auto available() -> size_t override;
 	auto close() -> void override;
@@ -35,26 +35,14 @@ void FileOutputStream::write(std::byte b) {
 	fileStream_.write(&byte, 1);
 }
 
-/// \brief Writes a sequence of bytes from a buffer to the file.
-/// \details The method writes data starting from the beginning of the buffer to the end of the buffer into the file stream.
-/// \param buffer The buffer containing the bytes to be written.
-void FileOutputStream::write(const std::vector<std::byte>& buffer) {
-	write(buffer, 0, buffer.size());
-}
-
-/// \brief Writes a sequence of bytes from a buffer to the file.
-/// \details The method writes data from the buffer starting at the specified \p offset and of the specified \p len into the file stream.
-/// \param buffer The buffer containing the bytes to be written.
-/// \param offset The starting offset in the buffer.
-/// \param len The number of bytes to be written.
-void FileOutputStream::write(const std::vector<std::byte>& buffer, const size_t offset, const size_t len) {
-	if (offset > buffer.size() || len > buffer.size() - offset) {
-		throw std::invalid_argument("Invalid buffer, offset, or length.");
-	}
+/// \brief Writes a sequence of bytes to the file.
+/// \details The method writes the caller's memory straight into the file stream.
+/// \param buffer The bytes to be written.
+void FileOutputStream::write(const std::span<const std::byte> buffer) {
 	if (!fileStream_) {
 		throw std::ios_base::failure("IOException: Stream is not writable.");
 	}
-	fileStream_.write(reinterpret_cast<const char*>(buffer.data() + offset), static_cast<std::streamsize>(len));
+	fileStream_.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
 }
 
 /// \brief Closes the file stream and releases any system resources associated with it.
@@ -21,9 +21,9 @@ public:
 	explicit FileOutputStream(const char* name, bool append = false);
 	explicit FileOutputStream(const std::filesystem::path& file, bool append = false);
 	~FileOutputStream() override;
+	using AbstractOutputStream::write;
 	void write(std::byte b) override;
-	void write(const std::vector<std::byte>& buffer) override;
-	void write(const std::vector<std::byte>& buffer, size_t offset, size_t len) override;
+	void write(std::span<const std::byte> buffer) override;
 	void close() override;
 	void flush() override;
 
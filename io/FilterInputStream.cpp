@@ -44,28 +44,17 @@ auto FilterInputStream::read() -> std::byte {
 	return inputStream_->read();
 }
 
-/// \brief Reads bytes into the provided buffer.
-/// \param buffer The buffer to fill with bytes.
+/// \brief Reads bytes into the provided memory.
+/// \details The request is passed on as is, so the underlying stream fills the caller's memory directly.
+/// \param buffer The memory to fill with bytes.
 /// \return The number of bytes read.
-size_t FilterInputStream::read(std::vector<std::byte>& buffer) {
+size_t FilterInputStream::read(const std::span<std::byte> buffer) {
 	if (!inputStream_) {
 		throw std::runtime_error("Input stream is not available");
 	}
 	return inputStream_->read(buffer);
 }
 
-/// \brief Reads bytes into the provided buffer starting at the given offset.
-/// \param buffer The buffer to fill with bytes.
-/// \param offset The start position in the buffer to write to.
-/// \param len The maximum number of bytes to read.
-/// \return The number of bytes read.
-size_t FilterInputStream::read(std::vector<std::byte>& buffer, const size_t offset, const size_t len) {
-	if (!inputStream_) {
-		throw std::runtime_error("Input stream is not available");
-	}
-	return inputStream_->read(buffer, offset, len);
-}
-
 /// \brief Resets the stream to the most recent mark.
 void FilterInputStream::reset() {
 	if (!inputStream_) {
@@ -16,9 +16,9 @@ public:
 	[[nodiscard]] auto available() -> size_t override;
 	auto mark(int readLimit) -> void override;
 	[[nodiscard]] auto markSupported() const -> bool override;
+	using AbstractInputStream::read;
 	auto read() -> std::byte override;
-	auto read(std::vector<std::byte>& buffer) -> size_t override;
-	auto read(std::vector<std::byte>& buffer, size_t offset, size_t len) -> size_t override;
+	auto read(std::span<std::byte> buffer) -> size_t override;
 	auto reset() -> void override;
 	auto skip(size_t n) -> size_t override;
 	auto close() -> void override;
@@ -18,31 +18,17 @@ auto FilterOutputStream::write(const std::byte b) -> void {
 	outputStream_->write(b);
 }
 
-/// \brief Writes the entire buffer to the stream.
-/// \param buffer The buffer containing the data to write.
+/// \brief Writes a block of memory to the stream.
+/// \details The request is passed on as is, so the underlying stream consumes the caller's memory directly.
+/// \param buffer The bytes to write.
 /// \throw std::runtime_error If the underlying stream is unavailable.
-void FilterOutputStream::write(const std::vector<std::byte>& buffer) {
+void FilterOutputStream::write(const std::span<const std::byte> buffer) {
 	if (!outputStream_) {
 		throw std::runtime_error("Output stream is not available");
 	}
 	outputStream_->write(buffer);
 }
 
-/// \brief Writes a portion of the buffer to the stream.
-/// \param buffer The buffer containing the data to write.
-/// \param offset The offset in the buffer at which to start writing.
-/// \param len The number of bytes to write.
-/// \throw std::runtime_error If the underlying stream is unavailable or the buffer is invalid.
-void FilterOutputStream::write(const std::vector<std::byte>& buffer, const size_t offset, const size_t len) {
-	if (!outputStream_) {
-		throw std::runtime_error("Output stream is not available");
-	}
-	if (offset + len > buffer.size()) {
-		throw std::out_of_range("Buffer overflow");
-	}
-	outputStream_->write(buffer, offset, len);
-}
-
 /// \brief Flushes the stream, forcing any buffered output bytes to be written.
 /// \throw std::runtime_error If the underlying stream is unavailable.
 auto FilterOutputStream::flush() -> void {
@@ -14,9 +14,9 @@ class FilterOutputStream : public AbstractOutputStream
 public:
 	explicit FilterOutputStream(std::shared_ptr<AbstractOutputStream> outputStream);
 	~FilterOutputStream() override;
+	using AbstractOutputStream::write;
 	auto write(std::byte b) -> void override;
-	auto write(const std::vector<std::byte>& buffer) -> void override;
-	auto write(const std::vector<std::byte>& buffer, size_t offset, size_t len) -> void override;
+	auto write(std::span<const std::byte> buffer) -> void override;
 	auto flush() -> void override;
 	auto close() -> void override;
 
@@ -0,0 +1,186 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#include "MappedFile.hpp"
+#include <algorithm>
+#include <ios>
+#include <stdexcept>
+#include <utility>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace common::io
+{
+MappedFile::MappedFile(const std::string& name, const AccessPattern pattern) : MappedFile(std::filesystem::path(name), pattern) {}
+
+MappedFile::MappedFile(const char* name, const AccessPattern pattern) : MappedFile(std::filesystem::path(name), pattern) {}
+
+/// \brief Maps a whole file into memory for reading.
+/// \param file The file to map.
+/// \param pattern The expected access pattern, passed to the kernel as a hint.
+/// \throws std::ios_base::failure if the file does not exist, is a directory or cannot be mapped.
+MappedFile::MappedFile(const std::filesystem::path& file, const AccessPattern pattern) {
+	if (!std::filesystem::exists(file)) {
+		throw std::ios_base::failure("FileNotFoundException: File does not exist.");
+	}
+	if (std::filesystem::is_directory(file)) {
+		throw std::ios_base::failure("FileNotFoundException: Path is a directory.");
+	}
+#ifdef _WIN32
+	const HANDLE handle = CreateFileW(file.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, pattern == AccessPattern::Sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (handle == INVALID_HANDLE_VALUE) {
+		throw std::ios_base::failure("FileNotFoundException: Unable to open file.");
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(handle, &fileSize)) {
+		CloseHandle(handle);
+		throw std::ios_base::failure("IOException: Unable to query file size.");
+	}
+	size_ = static_cast<size_t>(fileSize.QuadPart);
+	if (size_ > 0) {
+		const HANDLE mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping != nullptr) {
+			data_ = static_cast<std::byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+			CloseHandle(mapping);
+		}
+		if (data_ == nullptr) {
+			CloseHandle(handle);
+			throw std::ios_base::failure("IOException: Unable to map file.");
+		}
+	}
+	CloseHandle(handle);
+#else
+	const int fd = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		throw std::ios_base::failure("FileNotFoundException: Unable to open file.");
+	}
+	struct stat status{};
+	if (fstat(fd, &status) != 0) {
+		::close(fd);
+		throw std::ios_base::failure("IOException: Unable to query file size.");
+	}
+	size_ = static_cast<size_t>(status.st_size);
+	if (size_ > 0) {
+		void* address = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (address == MAP_FAILED) {
+			::close(fd);
+			throw std::ios_base::failure("IOException: Unable to map file.");
+		}
+		data_ = static_cast<std::byte*>(address);
+	}
+	// The mapping keeps the file referenced; the descriptor is no longer needed.
+	::close(fd);
+#endif
+	open_ = true;
+	advise(pattern);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)), open_(std::exchange(other.open_, false)) {}
+
+auto MappedFile::operator=(MappedFile&& other) noexcept -> MappedFile& {
+	if (this != &other) {
+		close();
+		data_ = std::exchange(other.data_, nullptr);
+		size_ = std::exchange(other.size_, 0);
+		open_ = std::exchange(other.open_, false);
+	}
+	return *this;
+}
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+/// \brief Returns a pointer to the first mapped byte, or nullptr for an empty or closed file.
+auto MappedFile::data() const -> const std::byte* {
+	return data_;
+}
+
+/// \brief Returns the number of mapped bytes.
+auto MappedFile::size() const -> size_t {
+	return size_;
+}
+
+/// \brief Returns a view of the whole file.
+auto MappedFile::bytes() const -> std::span<const std::byte> {
+	return {data_, size_};
+}
+
+/// \brief Returns a view of a range of the file.
+/// \param offset The offset of the first byte.
+/// \param len The number of bytes.
+/// \return The bytes in [offset, offset + len).
+/// \throws std::out_of_range if the range exceeds the file.
+auto MappedFile::subspan(const size_t offset, const size_t len) const -> std::span<const std::byte> {
+	if (offset > size_ || len > size_ - offset) {
+		throw std::out_of_range("Mapped file offset/length out of range");
+	}
+	return {data_ + offset, len};
+}
+
+/// \brief Tests whether the file is still mapped.
+auto MappedFile::isOpen() const -> bool {
+	return open_;
+}
+
+/// \brief Tells the kernel how the mapping is going to be accessed.
+/// \details Sequential doubles the readahead window and lets pages be dropped soon after they were read;
+/// Random disables readahead. The hint is advisory and ignored where the platform has no equivalent.
+/// \param pattern The expected access pattern.
+auto MappedFile::advise(const AccessPattern pattern) const -> void {
+#ifndef _WIN32
+	if (data_ == nullptr) return;
+	int advice = MADV_NORMAL;
+	if (pattern == AccessPattern::Sequential) {
+		advice = MADV_SEQUENTIAL;
+	}
+	else if (pattern == AccessPattern::Random) {
+		advice = MADV_RANDOM;
+	}
+	madvise(data_, size_, advice);
+#endif
+}
+
+/// \brief Asks the kernel to start reading a range of the file in the background.
+/// \details Call it ahead of the position being consumed so that page faults find the data already cached.
+/// The range is clamped to the file and widened to whole pages.
+/// \param offset The offset of the first byte needed soon.
+/// \param len The number of bytes needed soon.
+auto MappedFile::willNeed(const size_t offset, const size_t len) const -> void {
+	if (data_ == nullptr || offset >= size_) return;
+	const size_t end = offset + (std::min)(len, size_ - offset);
+#ifdef _WIN32
+	WIN32_MEMORY_RANGE_ENTRY range{data_ + offset, end - offset};
+	PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+	const auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	const size_t begin = offset / pageSize * pageSize;
+	madvise(data_ + begin, end - begin, MADV_WILLNEED);
+#endif
+}
+
+/// \brief Unmaps the file. Views obtained earlier become invalid.
+auto MappedFile::close() -> void {
+	if (data_ != nullptr) {
+#ifdef _WIN32
+		UnmapViewOfFile(data_);
+#else
+		munmap(data_, size_);
+#endif
+	}
+	data_ = nullptr;
+	size_ = 0;
+	open_ = false;
+}
+}
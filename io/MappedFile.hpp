@@ -0,0 +1,49 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <string>
+
+namespace common::io
+{
+/// \brief A read-only memory mapping of a whole file.
+/// \details The file is mapped once on construction and its bytes are then accessed in place, without
+/// read calls or copies; the kernel pages data in on demand. Access pattern hints let the kernel tune
+/// readahead: Sequential for scans, Random for lookups. Empty files are supported and yield an empty view.
+/// The mapping is immutable, so a MappedFile may be read from any number of threads at once.
+class MappedFile final
+{
+public:
+	/// \brief How the mapped bytes are going to be accessed.
+	enum class AccessPattern
+	{
+		Normal,
+		Sequential,
+		Random
+	};
+
+	explicit MappedFile(const std::string& name, AccessPattern pattern = AccessPattern::Normal);
+	explicit MappedFile(const char* name, AccessPattern pattern = AccessPattern::Normal);
+	explicit MappedFile(const std::filesystem::path& file, AccessPattern pattern = AccessPattern::Normal);
+	MappedFile(const MappedFile&) = delete;
+	auto operator=(const MappedFile&) -> MappedFile& = delete;
+	MappedFile(MappedFile&& other) noexcept;
+	auto operator=(MappedFile&& other) noexcept -> MappedFile&;
+	~MappedFile();
+	[[nodiscard]] auto data() const -> const std::byte*;
+	[[nodiscard]] auto size() const -> size_t;
+	[[nodiscard]] auto bytes() const -> std::span<const std::byte>;
+	[[nodiscard]] auto subspan(size_t offset, size_t len) const -> std::span<const std::byte>;
+	[[nodiscard]] auto isOpen() const -> bool;
+	auto advise(AccessPattern pattern) const -> void;
+	auto willNeed(size_t offset, size_t len) const -> void;
+	auto close() -> void;
+
+private:
+	std::byte* data_{nullptr};
+	size_t size_{0};
+	bool open_{false};
+};
+}
@@ -0,0 +1,116 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#include "MappedFileInputStream.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace common::io
+{
+MappedFileInputStream::MappedFileInputStream(const std::string& name) : MappedFileInputStream(MappedFile(name, MappedFile::AccessPattern::Sequential)) {}
+
+MappedFileInputStream::MappedFileInputStream(const char* name) : MappedFileInputStream(MappedFile(name, MappedFile::AccessPattern::Sequential)) {}
+
+MappedFileInputStream::MappedFileInputStream(const std::filesystem::path& file) : MappedFileInputStream(MappedFile(file, MappedFile::AccessPattern::Sequential)) {}
+
+/// \brief Creates a stream over an existing mapping, starting at its first byte.
+/// \param file The mapping, owned by the stream from now on.
+MappedFileInputStream::MappedFileInputStream(MappedFile file) : file_(std::move(file)) {
+	advance(0);
+}
+
+MappedFileInputStream::~MappedFileInputStream() {
+	MappedFileInputStream::close();
+}
+
+/// \brief Reads the next byte of data from this input stream.
+/// \return The next byte of data, or -1 if the end of the stream is reached.
+auto MappedFileInputStream::read() -> std::byte {
+	if (pos_ >= file_.size()) {
+		return static_cast<std::byte>(-1);
+	}
+	const std::byte byte = file_.data()[pos_];
+	advance(1);
+	return byte;
+}
+
+/// \brief Reads up to buffer.size() bytes of data from this input stream into the given memory.
+/// \details The bytes are copied from the mapping in a single operation.
+/// \param buffer The memory into which the data is read.
+/// \return The total number of bytes read into the buffer, or 0 if the end of the stream has been reached.
+auto MappedFileInputStream::read(const std::span<std::byte> buffer) -> size_t {
+	const size_t len = std::min(buffer.size(), file_.size() - pos_);
+	std::copy_n(file_.data() + pos_, len, buffer.begin());
+	advance(len);
+	return len;
+}
+
+/// \brief Skips over and discards n bytes of data from this input stream.
+/// \param n The number of bytes to skip.
+/// \return The number of bytes actually skipped.
+auto MappedFileInputStream::skip(const size_t n) -> size_t {
+	const size_t skipped = std::min(n, file_.size() - pos_);
+	advance(skipped);
+	return skipped;
+}
+
+/// \brief Returns the number of bytes left in the file.
+auto MappedFileInputStream::available() -> size_t {
+	return file_.size() - pos_;
+}
+
+/// \brief Marks the current position in the stream.
+/// \details The whole file stays mapped, so the mark never becomes invalid and the read limit is ignored.
+auto MappedFileInputStream::mark(int) -> void {
+	markPos_ = pos_;
+}
+
+/// \brief Tests if this input stream supports the mark and reset methods.
+/// \return true since any position of a mapped file can be returned to.
+auto MappedFileInputStream::markSupported() const -> bool {
+	return true;
+}
+
+/// \brief Resets the stream to the last marked position, or to the beginning if no mark was set.
+auto MappedFileInputStream::reset() -> void {
+	pos_ = markPos_;
+	readAheadPos_ = pos_;
+	advance(0);
+}
+
+/// \brief Unmaps the file. Views obtained from remaining() or mappedFile() become invalid.
+auto MappedFileInputStream::close() -> void {
+	file_.close();
+	pos_ = 0;
+	markPos_ = 0;
+	readAheadPos_ = 0;
+}
+
+/// \brief Returns the offset of the next byte to be read.
+auto MappedFileInputStream::position() const -> size_t {
+	return pos_;
+}
+
+/// \brief Returns a view of the bytes not read yet, valid until the stream is closed.
+/// \details Consuming part of the view does not move the stream; call skip() for that.
+auto MappedFileInputStream::remaining() const -> std::span<const std::byte> {
+	return file_.bytes().subspan(pos_);
+}
+
+/// \brief Returns the underlying mapping for random access.
+auto MappedFileInputStream::mappedFile() const -> const MappedFile& {
+	return file_;
+}
+
+/// \brief Moves the position forward and keeps the prefetched window ahead of it.
+/// \details A new prefetch is issued each time the position has consumed half of the last window, so the
+/// kernel is always reading between half a window and a whole window ahead of the consumer.
+/// \param n The number of bytes consumed.
+auto MappedFileInputStream::advance(const size_t n) -> void {
+	pos_ += n;
+	if (pos_ + READ_AHEAD_WINDOW / 2 >= readAheadPos_ && readAheadPos_ < file_.size()) {
+		const size_t from = std::max(pos_, readAheadPos_);
+		file_.willNeed(from, pos_ + READ_AHEAD_WINDOW - from);
+		readAheadPos_ = pos_ + READ_AHEAD_WINDOW;
+	}
+}
+}
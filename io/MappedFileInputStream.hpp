@@ -0,0 +1,47 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#pragma once
+#include <filesystem>
+#include <span>
+#include <string>
+#include "AbstractInputStream.hpp"
+#include "MappedFile.hpp"
+
+namespace common::io
+{
+/// \brief A class that reads bytes from a memory-mapped file.
+/// \details The file is mapped with a sequential access hint and read in place: available() is a subtraction,
+/// single-byte reads are a load and bulk reads a single memcpy from the mapping. The stream keeps asking the
+/// kernel to prefetch the next READ_AHEAD_WINDOW bytes as the position advances, so scans rarely block on a
+/// page fault. Besides the AbstractInputStream interface, remaining() and mappedFile() give direct access
+/// to the mapped bytes for parsers that want to avoid copying altogether.
+class MappedFileInputStream final : public AbstractInputStream
+{
+public:
+	explicit MappedFileInputStream(const std::string& name);
+	explicit MappedFileInputStream(const char* name);
+	explicit MappedFileInputStream(const std::filesystem::path& file);
+	explicit MappedFileInputStream(MappedFile file);
+	~MappedFileInputStream() override;
+	using AbstractInputStream::read;
+	auto read() -> std::byte override;
+	auto read(std::span<std::byte> buffer) -> size_t override;
+	auto skip(size_t n) -> size_t override;
+	[[nodiscard]] auto available() -> size_t override;
+	auto mark(int readLimit) -> void override;
+	[[nodiscard]] auto markSupported() const -> bool override;
+	auto reset() -> void override;
+	auto close() -> void override;
+	[[nodiscard]] auto position() const -> size_t;
+	[[nodiscard]] auto remaining() const -> std::span<const std::byte>;
+	[[nodiscard]] auto mappedFile() const -> const MappedFile&;
+
+private:
+	static constexpr size_t READ_AHEAD_WINDOW = 4 * 1024 * 1024;
+	auto advance(size_t n) -> void;
+	MappedFile file_;
+	size_t pos_{0};
+	size_t markPos_{0};
+	size_t readAheadPos_{0};
+};
+}
@@ -0,0 +1,58 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#include "ParallelFileReader.hpp"
+#include <algorithm>
+
+namespace common::io
+{
+/// \brief Maps a file and splits it into chunks of whole records.
+/// \param pool The pool providing the helper threads; it must outlive the reader.
+/// \param file The file to read.
+/// \param delimiter The character that ends a record.
+/// \param chunkCount The number of chunks to aim for, 0 for a few per pool thread.
+/// \throws std::ios_base::failure if the file cannot be opened or mapped.
+ParallelFileReader::ParallelFileReader(thread::ThreadPool& pool, const std::filesystem::path& file, const char delimiter, const size_t chunkCount) : ParallelFileReader(pool, MappedFile(file, MappedFile::AccessPattern::Sequential), delimiter, chunkCount) {}
+
+/// \brief Splits an existing mapping into chunks of whole records.
+/// \param pool The pool providing the helper threads; it must outlive the reader.
+/// \param file The mapping, owned by the reader from now on.
+/// \param delimiter The character that ends a record.
+/// \param chunkCount The number of chunks to aim for, 0 for a few per pool thread.
+ParallelFileReader::ParallelFileReader(thread::ThreadPool& pool, MappedFile file, const char delimiter, const size_t chunkCount) : pool_(pool), file_(std::move(file)), delimiter_(delimiter) {
+	split(chunkCount != 0 ? chunkCount : (pool_.GetPoolSize() + 1) * CHUNKS_PER_THREAD);
+}
+
+/// \brief Returns the whole file as text, valid as long as the reader.
+auto ParallelFileReader::data() const -> std::string_view {
+	return {reinterpret_cast<const char*>(file_.data()), file_.size()};
+}
+
+/// \brief Returns the chunks in file order. Each one ends just past a delimiter, except possibly the last.
+auto ParallelFileReader::chunks() const -> const std::vector<std::string_view>& {
+	return chunks_;
+}
+
+/// \brief Cuts the file at evenly spaced offsets moved forward to the next record boundary.
+/// \details Chunks are never smaller than MIN_CHUNK_SIZE, apart from the last one, so small files are not
+/// broken into pieces whose scheduling costs more than scanning them. A single record longer than a
+/// chunk swallows the boundaries that fall inside it, which leaves fewer chunks but never an empty one.
+/// \param chunkCount The number of chunks to aim for.
+auto ParallelFileReader::split(const size_t chunkCount) -> void {
+	const std::string_view text = data();
+	const size_t size = text.size();
+	if (size == 0) return;
+	const size_t chunkSize = std::max(MIN_CHUNK_SIZE, (size + chunkCount - 1) / chunkCount);
+	chunks_.reserve(size / chunkSize + 1);
+	size_t begin = 0;
+	while (begin < size) {
+		size_t end = size;
+		if (size - begin > chunkSize) {
+			const char* last = text.data() + size;
+			const char* found = ScanUtil::find(text.data() + begin + chunkSize - 1, last, delimiter_);
+			end = found == last ? size : static_cast<size_t>(found - text.data()) + 1;
+		}
+		chunks_.push_back(text.substr(begin, end - begin));
+		begin = end;
+	}
+}
+}
@@ -0,0 +1,213 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#pragma once
+#include <condition_variable>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+#include "MappedFile.hpp"
+#include "ScanUtil.hpp"
+#include "thread/ThreadPool.hpp"
+
+namespace common::io
+{
+/// \brief Processes one large file on every thread of a ThreadPool.
+/// \details The file is memory-mapped and split into byte ranges of roughly equal size. Every range is
+/// then moved forward to just past the next record delimiter, so no record is ever split between two
+/// chunks and each chunk is a self-contained run of whole records. The chunks are handed to the pool as
+/// std::string_view into the mapping, without copying.
+///
+/// Chunks are claimed dynamically by the calling thread and by helper tasks on the pool, so the calling
+/// thread always takes part, uneven chunks balance out, and the calls are safe from inside pool workers.
+/// The file is split into several chunks per thread for the same reason. Results can be collected in
+/// file order: mapChunks() hands each result to a consumer on the calling thread as soon as all earlier
+/// chunks are done, so the merge overlaps with the remaining work. The first exception thrown by a chunk
+/// function or by the consumer stops the remaining chunks and is rethrown to the caller.
+class ParallelFileReader final
+{
+public:
+	ParallelFileReader(thread::ThreadPool& pool, const std::filesystem::path& file, char delimiter = '\n', size_t chunkCount = 0);
+	ParallelFileReader(thread::ThreadPool& pool, MappedFile file, char delimiter = '\n', size_t chunkCount = 0);
+	[[nodiscard]] auto data() const -> std::string_view;
+	[[nodiscard]] auto chunks() const -> const std::vector<std::string_view>&;
+	template <class F> auto forEachChunk(F&& func) const -> void;
+	template <class F> auto forEachRecord(F&& func) const -> void;
+	template <class F> auto mapChunks(F&& func) const -> std::vector<std::invoke_result_t<F&, std::string_view>>;
+	template <class F, class Consumer> auto mapChunks(F&& func, Consumer&& consumer) const -> void;
+
+private:
+	static constexpr size_t CHUNKS_PER_THREAD = 4;
+	static constexpr size_t MIN_CHUNK_SIZE = 256 * 1024;
+	auto split(size_t chunkCount) -> void;
+	thread::ThreadPool& pool_;
+	MappedFile file_;
+	char delimiter_;
+	std::vector<std::string_view> chunks_;
+};
+
+/// \brief Calls a function for every chunk in parallel, in no particular order.
+/// \tparam F Callable as func(std::string_view chunk); it is called concurrently from several threads.
+template <class F> auto ParallelFileReader::forEachChunk(F&& func) const -> void {
+	mapChunks([&func](const std::string_view chunk) {
+		std::invoke(func, chunk);
+		return std::monostate{};
+	}, [](std::monostate) {});
+}
+
+/// \brief Calls a function for every record of the file in parallel.
+/// \details Records within a chunk are visited in order; records of different chunks concurrently.
+/// \tparam F Callable as func(std::string_view record), the record without its delimiter.
+template <class F> auto ParallelFileReader::forEachRecord(F&& func) const -> void {
+	forEachChunk([this, &func](const std::string_view chunk) {
+		const char* first = chunk.data();
+		const char* last = first + chunk.size();
+		while (first != last) {
+			const char* end = ScanUtil::find(first, last, delimiter_);
+			std::invoke(func, std::string_view(first, end));
+			first = end == last ? last : end + 1;
+		}
+	});
+}
+
+/// \brief Applies a function to every chunk in parallel and returns the results in file order.
+/// \tparam F Callable as func(std::string_view chunk), returning a non-void result.
+/// \return One result per chunk, the result of the first chunk first.
+template <class F> auto ParallelFileReader::mapChunks(F&& func) const -> std::vector<std::invoke_result_t<F&, std::string_view>> {
+	std::vector<std::invoke_result_t<F&, std::string_view>> results;
+	results.reserve(chunks_.size());
+	mapChunks(std::forward<F>(func), [&results](auto&& result) {
+		results.push_back(std::forward<decltype(result)>(result));
+	});
+	return results;
+}
+
+/// \brief Applies a function to every chunk in parallel and merges the results in file order.
+/// \details The consumer runs on the calling thread only, one result at a time and strictly in file
+/// order, so it needs no synchronization. A result is handed over as soon as it and every earlier one are
+/// ready; while the next result is still being computed, the calling thread processes chunks itself.
+/// \tparam F Callable as func(std::string_view chunk), returning a non-void result.
+/// \tparam Consumer Callable with an rvalue of the result type.
+template <class F, class Consumer> auto ParallelFileReader::mapChunks(F&& func, Consumer&& consumer) const -> void {
+	using R = std::invoke_result_t<F&, std::string_view>;
+	static_assert(!std::is_void_v<R>, "Use forEachChunk for functions without a result");
+	const size_t count = chunks_.size();
+	if (count == 0) return;
+
+	struct MergeState
+	{
+		/// \brief Claims the next chunk and runs it, or returns false once every chunk is claimed.
+		/// \details chunks and func are only dereferenced after a successful claim, so helpers that start
+		/// after the caller has returned find nothing to claim and never touch them.
+		auto RunOne() -> bool {
+			size_t index;
+			{
+				std::lock_guard lock(mutex);
+				if (next >= count) return false;
+				index = next++;
+				++running;
+			}
+			std::optional<R> result;
+			std::exception_ptr failure;
+			try {
+				result.emplace(std::invoke(*func, (*chunks)[index]));
+			}
+			catch (...) {
+				failure = std::current_exception();
+			}
+			{
+				std::lock_guard lock(mutex);
+				--running;
+				if (failure) {
+					Fail(failure);
+				}
+				else {
+					results[index] = std::move(result);
+				}
+			}
+			ready.notify_all();
+			return true;
+		}
+
+		/// \brief Records the first error and cancels the chunks not claimed yet. Requires the lock.
+		auto Fail(std::exception_ptr failure) -> void {
+			if (!error) {
+				error = std::move(failure);
+			}
+			next = count;
+		}
+
+		std::mutex mutex;
+		std::condition_variable ready;
+		const std::vector<std::string_view>* chunks;
+		std::remove_reference_t<F>* func;
+		size_t count;
+		std::vector<std::optional<R>> results;
+		size_t next{0};
+		size_t running{0};
+		std::exception_ptr error;
+	};
+
+	auto state = std::make_shared<MergeState>();
+	state->chunks = &chunks_;
+	state->func = &func;
+	state->count = count;
+	state->results.resize(count);
+	const size_t helpers = std::min(pool_.GetPoolSize(), count - 1);
+	for (size_t i = 0; i < helpers; ++i) {
+		try {
+			pool_.Execute([state] {
+				while (state->RunOne()) {}
+			});
+		}
+		catch (const std::runtime_error&) {
+			// The pool cannot take more work right now; the caller and the helpers already queued do the rest.
+			break;
+		}
+	}
+
+	for (size_t i = 0; i < count; ++i) {
+		std::optional<R> result;
+		{
+			std::unique_lock lock(state->mutex);
+			while (!state->error && !state->results[i]) {
+				if (state->next < count) {
+					lock.unlock();
+					state->RunOne();
+					lock.lock();
+				}
+				else {
+					state->ready.wait(lock);
+				}
+			}
+			if (state->error) break;
+			result = std::move(state->results[i]);
+			state->results[i].reset();
+		}
+		try {
+			std::invoke(consumer, std::move(*result));
+		}
+		catch (...) {
+			std::lock_guard lock(state->mutex);
+			state->Fail(std::current_exception());
+			break;
+		}
+	}
+
+	std::unique_lock lock(state->mutex);
+	state->ready.wait(lock, [&state] {
+		return state->running == 0;
+	});
+	if (state->error) {
+		std::rethrow_exception(state->error);
+	}
+}
+}
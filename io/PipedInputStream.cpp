@@ -1,6 +1,7 @@
 // Created by author ethereal on 2024/12/14.
 // Copyright (c) 2024 ethereal. All rights reserved.
 #include "PipedInputStream.hpp"
+#include <algorithm>
 
 namespace common::io
 {
@@ -50,21 +51,19 @@ auto PipedInputStream::read() -> std::byte {
 	return result;
 }
 
-/// \brief Reads up to \a len bytes of data from this input stream into the given array.
-/// \details Reads up to \a len bytes of data from this input stream into the given array starting at \a offset.
-/// \param[out] buffer The destination array.
-/// \param[in] offset The offset in the destination array where to start writing.
-/// \param[in] len The maximum number of bytes to read.
+/// \brief Reads up to \a buffer.size() bytes of data from this input stream into the given memory.
+/// \details Copies the buffered bytes in at most two contiguous runs, one on each side of the wrap-around point of the ring.
+/// \param[out] buffer The destination memory.
 /// \return The number of bytes read.
-/// \throw std::runtime_error If the end of the stream has been reached.
 /// \note This method is thread-safe as it locks the mutex before performing operations.
-size_t PipedInputStream::read(std::vector<std::byte>& buffer, const size_t offset, const size_t len) {
+size_t PipedInputStream::read(const std::span<std::byte> buffer) {
 	std::lock_guard lock(mutex_);
 	size_t bytesRead{0};
-	while (bytesRead < len && out_ != in_) {
-		buffer_[offset + bytesRead] = buffer_[out_];
-		++bytesRead;
-		out_ = (out_ + 1) % buffer_.size();
+	while (bytesRead < buffer.size() && out_ != in_) {
+		const size_t run = std::min(buffer.size() - bytesRead, (in_ > out_ ? in_ : buffer_.size()) - out_);
+		std::copy_n(buffer_.begin() + static_cast<std::ptrdiff_t>(out_), run, buffer.begin() + static_cast<std::ptrdiff_t>(bytesRead));
+		bytesRead += run;
+		out_ = (out_ + run) % buffer_.size();
 	}
 	return bytesRead;
 }
@@ -94,4 +93,23 @@ auto PipedInputStream::receive(const std::byte b) -> void {
 	buffer_[in_] = b;
 	in_ = (in_ + 1) % buffer_.size();
 }
+
+/// \brief Receives a block of data from the connected piped output stream.
+/// \details Copies as many bytes as fit into the ring, in at most two contiguous runs.
+/// \param[in] data The bytes to receive.
+/// \throw std::runtime_error If the piped input stream fills up before all bytes were received.
+auto PipedInputStream::receive(const std::span<const std::byte> data) -> void {
+	std::lock_guard lock(mutex_);
+	size_t received{0};
+	while (received < data.size()) {
+		const size_t free = (out_ + buffer_.size() - in_ - 1) % buffer_.size();
+		if (free == 0) {
+			throw std::runtime_error("PipedInputStream is overflow");
+		}
+		const size_t run = std::min({data.size() - received, free, buffer_.size() - in_});
+		std::copy_n(data.begin() + static_cast<std::ptrdiff_t>(received), run, buffer_.begin() + static_cast<std::ptrdiff_t>(in_));
+		received += run;
+		in_ = (in_ + run) % buffer_.size();
+	}
+}
 }
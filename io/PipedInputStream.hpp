@@ -24,10 +24,12 @@ public:
 	~PipedInputStream() override;
 	auto close() -> void override;
 	[[nodiscard]] auto available() -> size_t override;
+	using AbstractInputStream::read;
 	auto read() -> std::byte override;
-	auto read(std::vector<std::byte>& buffer, size_t offset, size_t len) -> size_t override;
+	auto read(std::span<std::byte> buffer) -> size_t override;
 	auto connect(std::shared_ptr<PipedOutputStream> src) -> void;
 	auto receive(std::byte b) -> void;
+	auto receive(std::span<const std::byte> data) -> void;
 
 protected:
 	std::vector<std::byte> buffer_{};
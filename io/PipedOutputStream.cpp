@@ -54,18 +54,13 @@ auto PipedOutputStream::write(const std::byte b) -> void {
 	snk_->receive(b);
 }
 
-/// \brief Writes a portion of a byte array to the piped output stream.
+/// \brief Writes a block of memory to the piped output stream.
 /// \details If the stream is not connected or if the stream is closed, the method throws an exception.
-/// Otherwise, it writes the specified portion of the byte array to the connected input stream.
-void PipedOutputStream::write(const std::vector<std::byte>& buffer, const size_t offset, const size_t len) {
+/// Otherwise, it writes the bytes to the connected input stream.
+void PipedOutputStream::write(const std::span<const std::byte> buffer) {
 	if (closed_ || !connected_ || !snk_) {
 		throw std::runtime_error("PipedOutputStream is not connected");
 	}
-	if (offset + len > buffer.size()) {
-		throw std::out_of_range("Buffer overflow");
-	}
-	for (size_t i = 0; i < len; ++i) {
-		snk_->receive(buffer[offset + i]);
-	}
+	snk_->receive(buffer);
 }
 }
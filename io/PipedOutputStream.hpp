@@ -22,8 +22,9 @@ public:
 	~PipedOutputStream() override;
 	auto close() -> void override;
 	auto flush() -> void override;
+	using AbstractOutputStream::write;
 	auto write(std::byte b) -> void override;
-	auto write(const std::vector<std::byte>& buffer, size_t offset, size_t len) -> void override;
+	auto write(std::span<const std::byte> buffer) -> void override;
 
 protected:
 	std::shared_ptr<PipedInputStream> snk_;
@@ -0,0 +1,141 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#include "PosixFileInputStream.hpp"
+// POSIX only, like FileDescriptor.
+#ifndef _WIN32
+#include <algorithm>
+#include <array>
+#include <ios>
+#include <utility>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace common::io
+{
+PosixFileInputStream::PosixFileInputStream(const std::string& name) : PosixFileInputStream(std::filesystem::path(name)) {}
+
+PosixFileInputStream::PosixFileInputStream(const char* name) : PosixFileInputStream(std::filesystem::path(name)) {}
+
+/// \brief Opens a file for reading.
+/// \throws std::ios_base::failure if the file does not exist, is a directory or cannot be opened.
+PosixFileInputStream::PosixFileInputStream(const std::filesystem::path& file) : PosixFileInputStream([&file] {
+	if (!std::filesystem::exists(file)) {
+		throw std::ios_base::failure("FileNotFoundException: File does not exist.");
+	}
+	if (std::filesystem::is_directory(file)) {
+		throw std::ios_base::failure("FileNotFoundException: Path is a directory.");
+	}
+	return FileDescriptor(file, O_RDONLY);
+}()) {}
+
+/// \brief Creates a stream reading from an open descriptor, which may also be a pipe or a socket.
+/// \param fd The descriptor, owned by the stream from now on.
+PosixFileInputStream::PosixFileInputStream(FileDescriptor fd) : fd_(std::move(fd)), regular_(fd_.isRegularFile()) {}
+
+PosixFileInputStream::~PosixFileInputStream() {
+	PosixFileInputStream::close();
+}
+
+/// \brief Reads the next byte of data from this input stream.
+/// \details Each call is a system call; use a BufferedInputStream for byte-wise reading.
+/// \return The next byte of data, or -1 if the end of the stream is reached.
+auto PosixFileInputStream::read() -> std::byte {
+	std::byte byte;
+	if (fd_.read(std::span(&byte, 1)) == 0) {
+		return static_cast<std::byte>(-1);
+	}
+	return byte;
+}
+
+/// \brief Reads up to buffer.size() bytes at the current offset straight into the given memory.
+/// \details Like read(2), a single call may return fewer bytes than requested before the end of the stream.
+/// \param buffer The memory into which the data is read.
+/// \return The number of bytes read, 0 at the end of the stream.
+auto PosixFileInputStream::read(const std::span<std::byte> buffer) -> size_t {
+	return fd_.read(buffer);
+}
+
+/// \brief Reads at a given offset without moving the stream, until the buffer is full or end of file.
+/// \details Safe to call from several threads at once.
+/// \param buffer The memory into which the data is read.
+/// \param offset The file offset of the first byte.
+/// \return The number of bytes read.
+auto PosixFileInputStream::readAt(const std::span<std::byte> buffer, const uint64_t offset) const -> size_t {
+	return fd_.readAt(buffer, offset);
+}
+
+/// \brief Reads a contiguous range at a given offset into several buffers without moving the stream.
+/// \details Safe to call from several threads at once.
+/// \param buffers The memory into which the data is read, filled in order.
+/// \param offset The file offset of the first byte.
+/// \return The number of bytes read.
+auto PosixFileInputStream::readAt(const std::span<const std::span<std::byte>> buffers, const uint64_t offset) const -> size_t {
+	return fd_.readAt(buffers, offset);
+}
+
+/// \brief Skips over and discards n bytes of data from this input stream.
+/// \details Regular files are skipped with a seek, clamped to the end of the file; other descriptors are read and discarded.
+/// \param n The number of bytes to skip.
+/// \return The number of bytes actually skipped.
+auto PosixFileInputStream::skip(const size_t n) -> size_t {
+	if (regular_) {
+		const uint64_t position = fd_.seek(0, SEEK_CUR);
+		const uint64_t size = fd_.size();
+		const uint64_t skipped = position < size ? std::min<uint64_t>(n, size - position) : 0;
+		fd_.seek(static_cast<int64_t>(skipped), SEEK_CUR);
+		return skipped;
+	}
+	std::array<std::byte, 4096> discard;
+	size_t skipped = 0;
+	while (skipped < n) {
+		const size_t bytesRead = fd_.read(std::span(discard).first(std::min(discard.size(), n - skipped)));
+		if (bytesRead == 0) break;
+		skipped += bytesRead;
+	}
+	return skipped;
+}
+
+/// \brief Returns the number of bytes that can be read without blocking.
+/// \details For regular files this is the distance to the end of the file; for pipes and sockets the
+/// number of bytes already queued.
+auto PosixFileInputStream::available() -> size_t {
+	if (regular_) {
+		const uint64_t position = fd_.seek(0, SEEK_CUR);
+		const uint64_t size = fd_.size();
+		return position < size ? size - position : 0;
+	}
+	int queued = 0;
+	if (::ioctl(fd_.get(), FIONREAD, &queued) != 0) {
+		return 0;
+	}
+	return static_cast<size_t>(queued);
+}
+
+/// \brief Closes the descriptor. Closing a closed stream has no effect.
+auto PosixFileInputStream::close() -> void {
+	fd_.close();
+}
+
+/// \brief Tests if this input stream supports the mark and reset methods.
+/// \return false; use readAt to re-read earlier data.
+auto PosixFileInputStream::markSupported() const -> bool {
+	return false;
+}
+
+/// \brief Tells the kernel how a range of the file is going to be read, see FileDescriptor::advise.
+auto PosixFileInputStream::advise(const FileDescriptor::Advice advice, const uint64_t offset, const uint64_t len) const -> void {
+	fd_.advise(advice, offset, len);
+}
+
+/// \brief Returns the size of the file.
+auto PosixFileInputStream::size() const -> uint64_t {
+	return fd_.size();
+}
+
+/// \brief Returns the underlying descriptor.
+auto PosixFileInputStream::getFileDescriptor() const -> const FileDescriptor& {
+	return fd_;
+}
+}
+#endif
@@ -0,0 +1,45 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include "AbstractInputStream.hpp"
+#include "FileDescriptor.hpp"
+
+namespace common::io
+{
+/// \brief A class that reads bytes from a file through a raw POSIX file descriptor.
+/// \details Unlike FileInputStream there is no iostream buffer in between: bulk reads go straight from the
+/// kernel into the caller's memory, so wrap the stream in a BufferedInputStream when reading small pieces.
+/// Besides the sequential stream interface it offers positional reads through readAt, which never touch
+/// the shared file offset; any number of threads may call readAt concurrently on one stream, and
+/// alongside sequential reads from the owning thread. Readahead hints are forwarded to posix_fadvise.
+/// \remark POSIX only.
+class PosixFileInputStream final : public AbstractInputStream
+{
+public:
+	explicit PosixFileInputStream(const std::string& name);
+	explicit PosixFileInputStream(const char* name);
+	explicit PosixFileInputStream(const std::filesystem::path& file);
+	explicit PosixFileInputStream(FileDescriptor fd);
+	~PosixFileInputStream() override;
+	using AbstractInputStream::read;
+	auto read() -> std::byte override;
+	auto read(std::span<std::byte> buffer) -> size_t override;
+	auto readAt(std::span<std::byte> buffer, uint64_t offset) const -> size_t;
+	auto readAt(std::span<const std::span<std::byte>> buffers, uint64_t offset) const -> size_t;
+	auto skip(size_t n) -> size_t override;
+	[[nodiscard]] auto available() -> size_t override;
+	auto close() -> void override;
+	[[nodiscard]] auto markSupported() const -> bool override;
+	auto advise(FileDescriptor::Advice advice, uint64_t offset = 0, uint64_t len = 0) const -> void;
+	[[nodiscard]] auto size() const -> uint64_t;
+	[[nodiscard]] auto getFileDescriptor() const -> const FileDescriptor&;
+
+private:
+	FileDescriptor fd_;
+	bool regular_;
+};
+}
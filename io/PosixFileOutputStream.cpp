@@ -0,0 +1,96 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#include "PosixFileOutputStream.hpp"
+// POSIX only, like FileDescriptor.
+#ifndef _WIN32
+#include <ios>
+#include <utility>
+#include <fcntl.h>
+
+namespace common::io
+{
+PosixFileOutputStream::PosixFileOutputStream(const std::string& name, const bool append) : PosixFileOutputStream(std::filesystem::path(name), append) {}
+
+PosixFileOutputStream::PosixFileOutputStream(const char* name, const bool append) : PosixFileOutputStream(std::filesystem::path(name), append) {}
+
+/// \brief Opens a file for writing, creating it if needed.
+/// \param file The file to write.
+/// \param append Whether to append to the existing content rather than truncate it.
+/// \throws std::ios_base::failure if the path is a directory or the file cannot be opened.
+PosixFileOutputStream::PosixFileOutputStream(const std::filesystem::path& file, const bool append) : PosixFileOutputStream([&file, append] {
+	if (std::filesystem::exists(file) && std::filesystem::is_directory(file)) {
+		throw std::ios_base::failure("FileNotFoundException: Path is a directory.");
+	}
+	return FileDescriptor(file, O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC));
+}()) {}
+
+/// \brief Creates a stream writing to an open descriptor, which may also be a pipe or a socket.
+/// \param fd The descriptor, owned by the stream from now on.
+PosixFileOutputStream::PosixFileOutputStream(FileDescriptor fd) : fd_(std::move(fd)) {}
+
+PosixFileOutputStream::~PosixFileOutputStream() {
+	PosixFileOutputStream::close();
+}
+
+/// \brief Writes a single byte.
+/// \details Each call is a system call; use a BufferedOutputStream for byte-wise writing.
+/// \param b The byte to be written.
+auto PosixFileOutputStream::write(const std::byte b) -> void {
+	fd_.write(std::span(&b, 1));
+}
+
+/// \brief Writes a block of memory at the current offset.
+/// \param buffer The bytes to be written.
+auto PosixFileOutputStream::write(const std::span<const std::byte> buffer) -> void {
+	fd_.write(buffer);
+}
+
+/// \brief Writes several buffers back to back at the current offset with a single gather call.
+/// \param buffers The blocks to be written, in order.
+auto PosixFileOutputStream::write(const std::span<const std::span<const std::byte>> buffers) -> void {
+	fd_.write(buffers);
+}
+
+/// \brief Writes a block of memory at a given offset without moving the stream.
+/// \details Safe to call from several threads at once. Not meaningful for streams opened in append mode.
+auto PosixFileOutputStream::writeAt(const std::span<const std::byte> buffer, const uint64_t offset) const -> void {
+	fd_.writeAt(buffer, offset);
+}
+
+/// \brief Writes several buffers back to back at a given offset without moving the stream.
+/// \details Safe to call from several threads at once. Not meaningful for streams opened in append mode.
+auto PosixFileOutputStream::writeAt(const std::span<const std::span<const std::byte>> buffers, const uint64_t offset) const -> void {
+	fd_.writeAt(buffers, offset);
+}
+
+/// \brief Reserves disk space for a range of the file, see FileDescriptor::preallocate.
+auto PosixFileOutputStream::preallocate(const uint64_t offset, const uint64_t len) const -> void {
+	fd_.preallocate(offset, len);
+}
+
+/// \brief Tells the kernel how a range of the file is going to be accessed, see FileDescriptor::advise.
+auto PosixFileOutputStream::advise(const FileDescriptor::Advice advice, const uint64_t offset, const uint64_t len) const -> void {
+	fd_.advise(advice, offset, len);
+}
+
+/// \brief Forces the written data to the storage device.
+auto PosixFileOutputStream::sync() const -> void {
+	fd_.sync();
+}
+
+/// \brief Does nothing: the stream keeps no user-space buffer. Use sync() for durability.
+auto PosixFileOutputStream::flush() -> void {
+	// Every write has already been handed to the kernel.
+}
+
+/// \brief Closes the descriptor. Closing a closed stream has no effect.
+auto PosixFileOutputStream::close() -> void {
+	fd_.close();
+}
+
+/// \brief Returns the underlying descriptor.
+auto PosixFileOutputStream::getFileDescriptor() const -> const FileDescriptor& {
+	return fd_;
+}
+}
+#endif
@@ -0,0 +1,44 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include "AbstractOutputStream.hpp"
+#include "FileDescriptor.hpp"
+
+namespace common::io
+{
+/// \brief A class that writes bytes to a file through a raw POSIX file descriptor.
+/// \details Unlike FileOutputStream there is no iostream buffer in between: every write is a system call
+/// that consumes the caller's memory directly, so wrap the stream in a BufferedOutputStream when writing
+/// small pieces. Several buffers can be written with a single gather call, at the current offset or at an
+/// explicit one; positional writes never touch the shared file offset and may be issued from several
+/// threads at once. preallocate reserves disk space up front and sync forces data to the device.
+/// \remark POSIX only.
+class PosixFileOutputStream final : public AbstractOutputStream
+{
+public:
+	explicit PosixFileOutputStream(const std::string& name, bool append = false);
+	explicit PosixFileOutputStream(const char* name, bool append = false);
+	explicit PosixFileOutputStream(const std::filesystem::path& file, bool append = false);
+	explicit PosixFileOutputStream(FileDescriptor fd);
+	~PosixFileOutputStream() override;
+	using AbstractOutputStream::write;
+	auto write(std::byte b) -> void override;
+	auto write(std::span<const std::byte> buffer) -> void override;
+	auto write(std::span<const std::span<const std::byte>> buffers) -> void;
+	auto writeAt(std::span<const std::byte> buffer, uint64_t offset) const -> void;
+	auto writeAt(std::span<const std::span<const std::byte>> buffers, uint64_t offset) const -> void;
+	auto preallocate(uint64_t offset, uint64_t len) const -> void;
+	auto advise(FileDescriptor::Advice advice, uint64_t offset = 0, uint64_t len = 0) const -> void;
+	auto sync() const -> void;
+	auto flush() -> void override;
+	auto close() -> void override;
+	[[nodiscard]] auto getFileDescriptor() const -> const FileDescriptor&;
+
+private:
+	FileDescriptor fd_;
+};
+}
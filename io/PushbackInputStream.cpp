@@ -1,6 +1,7 @@
 // Created by author ethereal on 2024/12/15.
 // Copyright (c) 2024 ethereal. All rights reserved.
 #include "PushbackInputStream.hpp"
+#include <algorithm>
 
 namespace common::io
 {
@@ -27,39 +28,37 @@ std::byte PushbackInputStream::read() {
 	return inputStream_->read();
 }
 
-/// \brief Reads bytes from this input stream into the specified buffer.
-/// \details Attempts to read up to buffer.size() bytes into the provided buffer vector.
-/// \param buffer The buffer into which the data is read.
-/// \return The total number of bytes read into the buffer, or -1 if the end of the stream has been reached.
-size_t PushbackInputStream::read(std::vector<std::byte>& buffer) {
-	return read(buffer, 0, buffer.size());
+/// \brief Reads bytes from this input stream into the specified memory.
+/// \details Pushed back bytes are copied first; the rest of the request goes straight to the underlying stream.
+/// \param buffer The memory into which the data is read.
+/// \return The total number of bytes read into the buffer.
+size_t PushbackInputStream::read(const std::span<std::byte> buffer) {
+	const size_t pushedBack = std::min(buffer.size(), pushbackBuffer_.size() - bufferPos_);
+	std::copy_n(pushbackBuffer_.begin() + static_cast<std::ptrdiff_t>(bufferPos_), pushedBack, buffer.begin());
+	bufferPos_ += pushedBack;
+	size_t bytesRead = pushedBack;
+	if (bytesRead < buffer.size()) {
+		bytesRead += inputStream_->read(buffer.subspan(bytesRead));
+	}
+	return bytesRead;
 }
 
-/// \brief Reads bytes from this input stream into the specified buffer.
-/// \details Attempts to read up to len bytes into the provided buffer vector, starting at the offset.
-/// \param buffer The buffer into which the data is read.
-/// \param offset The starting position in the buffer.
-/// \param len The maximum number of bytes to read.
-/// \return The total number of bytes read into the buffer, or -1 if the end of the stream has been reached.
-size_t PushbackInputStream::read(std::vector<std::byte>& buffer, const size_t offset, const size_t len) {
-	if (offset + len > buffer.size()) {
-		throw std::out_of_range("Buffer overflow");
-	}
-	size_t bytesRead = 0;
-	while (bytesRead < len && bufferPos_ < pushbackBuffer_.size()) {
-		buffer[offset + bytesRead++] = pushbackBuffer_[bufferPos_++];
-	}
-	if (bytesRead < len) {
-		bytesRead += inputStream_->read(buffer, offset + bytesRead, len - bytesRead);
+/// \brief Pushes back a block of bytes onto this stream.
+/// \details The bytes are pushed back onto this stream, and the next read will return the first of them.
+/// \param buffer The bytes to push back.
+void PushbackInputStream::unread(const std::span<const std::byte> buffer) {
+	if (buffer.size() > bufferPos_) {
+		throw std::overflow_error("Pushback buffer overflow");
 	}
-	return bytesRead;
+	bufferPos_ -= buffer.size();
+	std::copy(buffer.begin(), buffer.end(), pushbackBuffer_.begin() + static_cast<std::ptrdiff_t>(bufferPos_));
 }
 
 /// \brief Pushes back a buffer of bytes onto this stream.
 /// \details The buffer is pushed back onto this stream, and the next read will return the first byte of the buffer.
 /// \param buffer The buffer to push back.
 void PushbackInputStream::unread(const std::vector<std::byte>& buffer) {
-	unread(buffer, 0, buffer.size());
+	unread(std::span(buffer));
 }
 
 /// \brief Pushes back a buffer of bytes onto this stream.
@@ -68,12 +67,10 @@ void PushbackInputStream::unread(const std::vector<std::byte>& buffer) {
 /// \param offset The starting offset in the buffer.
 /// \param len The number of bytes to push back.
 void PushbackInputStream::unread(const std::vector<std::byte>& buffer, const size_t offset, const size_t len) {
-	if (len > bufferPos_) {
-		throw std::overflow_error("Pushback buffer overflow");
-	}
-	for (size_t i = 0; i < len; ++i) {
-		pushbackBuffer_[--bufferPos_] = buffer[offset + len - i - 1];
+	if (offset + len > buffer.size()) {
+		throw std::out_of_range("Buffer overflow");
 	}
+	unread(std::span(buffer).subspan(offset, len));
 }
 
 /// \brief Pushes back a single byte onto this stream.
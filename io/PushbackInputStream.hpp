@@ -15,9 +15,10 @@ public:
 	explicit PushbackInputStream(std::unique_ptr<AbstractInputStream> inputStream, size_t bufferSize = 64);
 	~PushbackInputStream() override;
 	auto available() -> size_t override;
+	using FilterInputStream::read;
 	auto read() -> std::byte override;
-	auto read(std::vector<std::byte>& buffer) -> size_t override;
-	auto read(std::vector<std::byte>& buffer, size_t offset, size_t len) -> size_t override;
+	auto read(std::span<std::byte> buffer) -> size_t override;
+	void unread(std::span<const std::byte> buffer);
 	void unread(const std::vector<std::byte>& buffer);
 	void unread(const std::vector<std::byte>& buffer, size_t offset, size_t len);
 	void unread(std::byte b);
@@ -0,0 +1,241 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#include "ReadAheadInputStream.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include "thread/DiscardGuard.hpp"
+
+namespace common::io
+{
+/// \brief Creates a stream that reads ahead on a dedicated thread.
+/// \param in The stream to read from, owned by this stream from now on.
+/// \param bufferSize The size of each buffer.
+/// \param depth The number of buffers, the one being drained included.
+/// \throws std::invalid_argument if the buffer size is zero or the depth is less than 2.
+ReadAheadInputStream::ReadAheadInputStream(std::unique_ptr<AbstractInputStream> in, const size_t bufferSize, const size_t depth) : FilterInputStream(std::move(in)) {
+	start(bufferSize, depth);
+}
+
+/// \brief Creates a stream that reads ahead in tasks of a pool.
+/// \param in The stream to read from, owned by this stream from now on.
+/// \param pool The pool running the loader; it must outlive the stream.
+/// \param bufferSize The size of each buffer.
+/// \param depth The number of buffers, the one being drained included.
+/// \throws std::invalid_argument if the buffer size is zero or the depth is less than 2.
+ReadAheadInputStream::ReadAheadInputStream(std::unique_ptr<AbstractInputStream> in, thread::ThreadPool& pool, const size_t bufferSize, const size_t depth) : FilterInputStream(std::move(in)), pool_(&pool) {
+	start(bufferSize, depth);
+}
+
+ReadAheadInputStream::~ReadAheadInputStream() {
+	ReadAheadInputStream::close();
+}
+
+/// \brief Returns the number of bytes already loaded and not read yet.
+/// \details The underlying stream is not asked, as the loader may be reading from it.
+auto ReadAheadInputStream::available() -> size_t {
+	size_t total = current_.length - current_.pos;
+	std::lock_guard lock(mutex_);
+	for (const Chunk& chunk : filled_) {
+		total += chunk.length;
+	}
+	return total;
+}
+
+/// \brief Stops the loader, waiting for a read in progress, and closes the underlying stream.
+/// \details Closing a previously closed stream has no effect.
+auto ReadAheadInputStream::close() -> void {
+	{
+		std::unique_lock lock(mutex_);
+		if (closing_) return;
+		closing_ = true;
+		changed_.notify_all();
+		if (pool_ != nullptr) {
+			changed_.wait(lock, [this] {
+				return !loading_;
+			});
+		}
+	}
+	if (loader_.joinable()) {
+		loader_.join();
+	}
+	filled_.clear();
+	free_.clear();
+	current_ = {};
+	inputStream_->close();
+}
+
+/// \brief Marking is not supported, since the loaded buffers are recycled once drained.
+/// \throws std::runtime_error Always.
+auto ReadAheadInputStream::mark(int) -> void {
+	throw std::runtime_error("mark not supported");
+}
+
+/// \brief Tests if this input stream supports the mark and reset methods.
+/// \return false since buffers are recycled once drained.
+auto ReadAheadInputStream::markSupported() const -> bool {
+	return false;
+}
+
+/// \brief Reads the next byte of data from this input stream.
+/// \return The next byte of data, or -1 if the end of the stream is reached.
+auto ReadAheadInputStream::read() -> std::byte {
+	if (current_.pos >= current_.length && !nextChunk()) {
+		return static_cast<std::byte>(-1);
+	}
+	return current_.data[current_.pos++];
+}
+
+/// \brief Reads up to buffer.size() bytes from the loaded buffers, waiting for the loader as needed.
+/// \param buffer The memory into which the data is read.
+/// \return The number of bytes read, 0 at the end of the stream.
+/// \throws std::ios_base::failure or any other exception thrown by the underlying stream.
+auto ReadAheadInputStream::read(const std::span<std::byte> buffer) -> size_t {
+	return consume(buffer.size(), buffer.data());
+}
+
+/// \brief Resetting is not supported, since the loaded buffers are recycled once drained.
+/// \throws std::runtime_error Always.
+auto ReadAheadInputStream::reset() -> void {
+	throw std::runtime_error("reset not supported");
+}
+
+/// \brief Skips over and discards n bytes of data from this input stream.
+/// \return The number of bytes actually skipped.
+auto ReadAheadInputStream::skip(const size_t n) -> size_t {
+	return consume(n, nullptr);
+}
+
+/// \brief Allocates the buffers and starts the loader.
+auto ReadAheadInputStream::start(const size_t bufferSize, const size_t depth) -> void {
+	if (bufferSize == 0 || depth < 2) {
+		throw std::invalid_argument("Buffer size must be greater than zero and depth at least 2");
+	}
+	free_.reserve(depth);
+	for (size_t i = 0; i < depth; ++i) {
+		free_.emplace_back(bufferSize);
+	}
+	loading_ = true;
+	if (pool_ != nullptr) {
+		launchLoader();
+	}
+	else {
+		loader_ = std::thread(&ReadAheadInputStream::loadLoop, this);
+	}
+}
+
+/// \brief Fills free buffers from the underlying stream until the end of the stream, an error or close.
+/// \details The dedicated thread waits for the consumer to free a buffer; a pool task returns instead
+/// and is launched again by nextChunk(). The lock is not held while reading.
+auto ReadAheadInputStream::loadLoop() -> void {
+	std::unique_lock lock(mutex_);
+	while (!closing_ && !eof_ && !error_) {
+		if (free_.empty()) {
+			if (pool_ != nullptr) break;
+			changed_.wait(lock);
+			continue;
+		}
+		Chunk chunk{std::move(free_.back())};
+		free_.pop_back();
+		lock.unlock();
+		std::exception_ptr failure;
+		try {
+			chunk.length = inputStream_->read(std::span(chunk.data));
+			if (chunk.length == static_cast<size_t>(-1)) {
+				chunk.length = 0;
+			}
+		}
+		catch (...) {
+			failure = std::current_exception();
+		}
+		lock.lock();
+		if (failure) {
+			error_ = failure;
+		}
+		else if (chunk.length == 0) {
+			eof_ = true;
+		}
+		if (chunk.length > 0) {
+			filled_.push_back(std::move(chunk));
+		}
+		else {
+			free_.push_back(std::move(chunk.data));
+		}
+		changed_.notify_all();
+	}
+	loading_ = false;
+	changed_.notify_all();
+}
+
+/// \brief Hands loadLoop() to the pool; loading_ must already be set.
+/// \details If the pool rejects the task or discards it before it runs, loading_ is cleared again, which
+/// makes the consumer load the next buffer itself. The task is submitted without holding the lock, as a
+/// CallerRuns pool runs it on this thread.
+auto ReadAheadInputStream::launchLoader() -> void {
+	thread::DiscardGuard guard([this]() noexcept {
+		std::lock_guard lock(mutex_);
+		loading_ = false;
+		changed_.notify_all();
+	});
+	pool_->TryExecute([this, guard = std::move(guard)]() mutable {
+		guard.Dismiss();
+		loadLoop();
+	});
+}
+
+/// \brief Recycles the drained buffer and takes the next loaded one, waiting for it if needed.
+/// \return false at the end of the stream or once closed.
+/// \throws Any exception the underlying stream threw, after the buffers loaded before it are drained.
+auto ReadAheadInputStream::nextChunk() -> bool {
+	std::unique_lock lock(mutex_);
+	if (!current_.data.empty()) {
+		free_.push_back(std::move(current_.data));
+		current_ = {};
+		if (pool_ == nullptr) {
+			changed_.notify_all();
+		}
+		else if (!loading_ && !eof_ && !error_ && !closing_) {
+			loading_ = true;
+			lock.unlock();
+			launchLoader();
+			lock.lock();
+		}
+	}
+	while (filled_.empty()) {
+		if (error_) {
+			std::rethrow_exception(error_);
+		}
+		if (eof_ || closing_) {
+			return false;
+		}
+		if (!loading_) {
+			loading_ = true;
+			lock.unlock();
+			loadLoop();
+			lock.lock();
+			continue;
+		}
+		changed_.wait(lock);
+	}
+	current_ = std::move(filled_.front());
+	filled_.pop_front();
+	return true;
+}
+
+/// \brief Takes up to n bytes from the loaded buffers.
+/// \param n The number of bytes wanted.
+/// \param target Where to copy them, or nullptr to discard them.
+/// \return The number of bytes taken.
+auto ReadAheadInputStream::consume(const size_t n, std::byte* target) -> size_t {
+	size_t taken = 0;
+	while (taken < n) {
+		if (current_.pos >= current_.length && !nextChunk()) break;
+		const size_t count = std::min(n - taken, current_.length - current_.pos);
+		if (target != nullptr) {
+			std::copy_n(current_.data.begin() + static_cast<std::ptrdiff_t>(current_.pos), count, target + taken);
+		}
+		current_.pos += count;
+		taken += count;
+	}
+	return taken;
+}
+}
@@ -0,0 +1,74 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+#include "FilterInputStream.hpp"
+#include "thread/ThreadPool.hpp"
+
+namespace common::io
+{
+/// \brief A class that reads the underlying stream ahead of the consumer on another thread.
+/// \details The stream owns depth buffers of bufferSize bytes. A loader fills free buffers from the
+/// underlying stream in the background while the consumer drains the buffer it holds, so the time spent
+/// blocked in the underlying read overlaps with the time spent processing the previous buffer; with the
+/// minimum depth of 2 this is classic double buffering. Only the hand-over of a whole buffer takes the
+/// lock, reads within a buffer are plain copies.
+///
+/// The loader is either a dedicated thread or, when a ThreadPool is given, a task that is resubmitted
+/// whenever a buffer becomes free and finishes as soon as every buffer is full, so it never occupies a
+/// worker while waiting for the consumer. If the pool rejects the task or discards it before it runs, the
+/// consumer loads the next buffer itself. The underlying stream is only ever read by one loader at a time,
+/// and not at all by the consumer; an exception thrown by it is rethrown to the consumer once the buffers
+/// loaded before it are drained.
+class ReadAheadInputStream final : public FilterInputStream
+{
+public:
+	explicit ReadAheadInputStream(std::unique_ptr<AbstractInputStream> in, size_t bufferSize = DEFAULT_BUFFER_SIZE, size_t depth = DEFAULT_DEPTH);
+	ReadAheadInputStream(std::unique_ptr<AbstractInputStream> in, thread::ThreadPool& pool, size_t bufferSize = DEFAULT_BUFFER_SIZE, size_t depth = DEFAULT_DEPTH);
+	~ReadAheadInputStream() override;
+	[[nodiscard]] auto available() -> size_t override;
+	auto close() -> void override;
+	auto mark(int readLimit) -> void override;
+	[[nodiscard]] auto markSupported() const -> bool override;
+	using FilterInputStream::read;
+	auto read() -> std::byte override;
+	auto read(std::span<std::byte> buffer) -> size_t override;
+	auto reset() -> void override;
+	auto skip(size_t n) -> size_t override;
+
+private:
+	static constexpr size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+	static constexpr size_t DEFAULT_DEPTH = 2;
+
+	/// \brief A buffer loaded from the underlying stream.
+	struct Chunk
+	{
+		std::vector<std::byte> data;
+		size_t length{0};
+		size_t pos{0};
+	};
+
+	auto start(size_t bufferSize, size_t depth) -> void;
+	auto loadLoop() -> void;
+	auto launchLoader() -> void;
+	auto nextChunk() -> bool;
+	auto consume(size_t n, std::byte* target) -> size_t;
+	thread::ThreadPool* pool_{nullptr};
+	Chunk current_;
+	std::deque<Chunk> filled_;
+	std::vector<std::vector<std::byte>> free_;
+	bool loading_{false};
+	bool eof_{false};
+	bool closing_{false};
+	std::exception_ptr error_;
+	std::mutex mutex_;
+	std::condition_variable changed_;
+	std::thread loader_;
+};
+}
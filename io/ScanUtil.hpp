@@ -0,0 +1,110 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define COMMON_IO_SCAN_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define COMMON_IO_SCAN_SSE2 1
+#endif
+
+namespace common::io
+{
+/// \brief Vectorized search for a single character in a block of text.
+/// \details Text readers spend most of their time looking for the next delimiter. Comparing one character
+/// at a time costs a branch per byte; here 16 (SSE2) or 32 (AVX2) bytes are compared in one instruction
+/// and the compare mask is reduced with movemask, so a whole 64-byte cache line is tested per loop
+/// iteration with a single branch. The instruction set is chosen at compile time: AVX2 when the build
+/// targets it (-mavx2, /arch:AVX2), otherwise SSE2, which every x86-64 CPU has. Other targets fall back
+/// to std::memchr, which the C library already vectorizes for the platform.
+class ScanUtil abstract
+{
+public:
+	static auto find(const char* first, const char* last, char value) -> const char*;
+	static auto contains(const char* first, const char* last, char value) -> bool;
+
+private:
+	static auto findTail(const char* first, const char* last, char value) -> const char*;
+};
+
+/// \brief Finds the first occurrence of a character.
+/// \param first The start of the text.
+/// \param last One past the end of the text.
+/// \param value The character to look for.
+/// \return A pointer to the first occurrence, or last if there is none.
+inline auto ScanUtil::find(const char* first, const char* last, const char value) -> const char* {
+#if defined(COMMON_IO_SCAN_AVX2)
+	const __m256i needle = _mm256_set1_epi8(value);
+	while (last - first >= 64) {
+		const __m256i a = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first)), needle);
+		const __m256i b = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + 32)), needle);
+		if (_mm256_movemask_epi8(_mm256_or_si256(a, b)) != 0) {
+			if (const auto mask = static_cast<unsigned>(_mm256_movemask_epi8(a)); mask != 0) {
+				return first + std::countr_zero(mask);
+			}
+			return first + 32 + std::countr_zero(static_cast<unsigned>(_mm256_movemask_epi8(b)));
+		}
+		first += 64;
+	}
+	while (last - first >= 32) {
+		const __m256i a = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first)), needle);
+		if (const auto mask = static_cast<unsigned>(_mm256_movemask_epi8(a)); mask != 0) {
+			return first + std::countr_zero(mask);
+		}
+		first += 32;
+	}
+	return findTail(first, last, value);
+#elif defined(COMMON_IO_SCAN_SSE2)
+	const __m128i needle = _mm_set1_epi8(value);
+	while (last - first >= 64) {
+		const __m128i a = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first)), needle);
+		const __m128i b = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first + 16)), needle);
+		const __m128i c = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first + 32)), needle);
+		const __m128i d = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first + 48)), needle);
+		if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d))) != 0) {
+			const uint64_t mask = static_cast<uint64_t>(_mm_movemask_epi8(a))
+				| static_cast<uint64_t>(_mm_movemask_epi8(b)) << 16
+				| static_cast<uint64_t>(_mm_movemask_epi8(c)) << 32
+				| static_cast<uint64_t>(_mm_movemask_epi8(d)) << 48;
+			return first + std::countr_zero(mask);
+		}
+		first += 64;
+	}
+	return findTail(first, last, value);
+#else
+	const void* hit = std::memchr(first, static_cast<unsigned char>(value), static_cast<size_t>(last - first));
+	return hit != nullptr ? static_cast<const char*>(hit) : last;
+#endif
+}
+
+/// \brief Tests whether a character occurs in the text.
+inline auto ScanUtil::contains(const char* first, const char* last, const char value) -> bool {
+	return find(first, last, value) != last;
+}
+
+/// \brief Finishes a search over the last bytes, fewer than one loop iteration of the vector path.
+inline auto ScanUtil::findTail(const char* first, const char* last, const char value) -> const char* {
+#if defined(COMMON_IO_SCAN_SSE2)
+	const __m128i needle = _mm_set1_epi8(value);
+	while (last - first >= 16) {
+		const __m128i a = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first)), needle);
+		if (const auto mask = static_cast<unsigned>(_mm_movemask_epi8(a)); mask != 0) {
+			return first + std::countr_zero(mask);
+		}
+		first += 16;
+	}
+#endif
+	for (; first != last; ++first) {
+		if (*first == value) {
+			return first;
+		}
+	}
+	return last;
+}
+}
@@ -0,0 +1,57 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace common::thread
+{
+/// \brief Tells the core that the calling thread is busy-waiting.
+/// \details On x86 this is the pause instruction and on ARM the yield hint. It lowers the power drawn by a
+/// spin loop, frees execution resources for a sibling hyper-thread and avoids the memory order violation
+/// penalty when the awaited cache line finally changes.
+inline auto CpuRelax() -> void {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+	_mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+	asm volatile("yield" ::: "memory");
+#endif
+}
+
+/// \brief Exponential backoff for spin loops.
+/// \details Every call to Pause spins twice as long as the previous one, up to a cap, so that threads
+/// contending for the same cache line spread their retries out instead of hitting it in lockstep.
+/// Once the spin budget is used up the caller is expected to block instead of spinning further.
+class Backoff
+{
+public:
+	/// \brief Spins for the current delay and doubles it.
+	auto Pause() -> void {
+		for (uint32_t i = 0; i < delay_; ++i) {
+			CpuRelax();
+		}
+		spent_ += delay_;
+		delay_ = std::min(delay_ * 2, MAX_DELAY);
+	}
+
+	/// \brief Returns whether the spin budget is used up.
+	[[nodiscard]] auto Exhausted() const -> bool {
+		return spent_ >= SPIN_BUDGET;
+	}
+
+	/// \brief Starts over with the shortest delay and a full budget.
+	auto Reset() -> void {
+		delay_ = 1;
+		spent_ = 0;
+	}
+
+private:
+	static constexpr uint32_t MAX_DELAY = 64;
+	static constexpr uint32_t SPIN_BUDGET = 1024;
+	uint32_t delay_{1};
+	uint32_t spent_{0};
+};
+}
@@ -0,0 +1,189 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "CacheLine.hpp"
+
+namespace common::thread
+{
+/// \brief A bounded lock-free ring queue (Vyukov).
+/// \tparam T The element type; it must be nothrow move constructible.
+/// \tparam MultiProducer Whether several threads may push concurrently.
+/// \tparam MultiConsumer Whether several threads may pop concurrently.
+/// \details Every slot carries a sequence number telling producers and consumers whether it is free for
+/// the current lap of the ring, so a push or a pop claims its position with a single compare-and-swap
+/// and never waits for another thread. The producer and consumer positions sit on separate cache lines.
+/// When only one thread produces or consumes, the corresponding position is advanced with a plain store
+/// instead of a compare-and-swap; use the MpscQueue and SpscQueue aliases for these cases. The capacity
+/// is fixed and rounded up to a power of two; pushing into a full queue fails instead of blocking.
+template <typename T, bool MultiProducer = true, bool MultiConsumer = true> class BoundedQueue
+{
+	static_assert(std::is_nothrow_move_constructible_v<T>, "BoundedQueue elements must be nothrow move constructible");
+
+public:
+	explicit BoundedQueue(size_t capacity);
+	BoundedQueue(const BoundedQueue&) = delete;
+	auto operator=(const BoundedQueue&) -> BoundedQueue& = delete;
+	~BoundedQueue();
+	template <typename... Args> auto TryEmplace(Args&&... args) -> bool;
+	auto TryPush(const T& item) -> bool;
+	auto TryPush(T&& item) -> bool;
+	auto TryPop() -> std::optional<T>;
+	[[nodiscard]] auto Capacity() const -> size_t;
+	[[nodiscard]] auto Size() const -> size_t;
+	[[nodiscard]] auto Empty() const -> bool;
+
+private:
+	struct Slot
+	{
+		std::atomic<size_t> sequence;
+		alignas(T) std::byte storage[sizeof(T)];
+	};
+
+	static auto RoundCapacity(size_t capacity) -> size_t;
+	size_t mask_;
+	std::unique_ptr<Slot[]> slots_;
+	alignas(CACHE_LINE_SIZE) std::atomic<size_t> enqueuePosition_{0};
+	alignas(CACHE_LINE_SIZE) std::atomic<size_t> dequeuePosition_{0};
+};
+
+/// \brief A bounded queue for any number of producers and consumers.
+template <typename T> using MpmcQueue = BoundedQueue<T, true, true>;
+/// \brief A bounded queue for any number of producers and a single consumer.
+template <typename T> using MpscQueue = BoundedQueue<T, true, false>;
+/// \brief A bounded queue for a single producer and a single consumer.
+template <typename T> using SpscQueue = BoundedQueue<T, false, false>;
+
+/// \brief Rounds a capacity up to a power of two, at least two.
+/// \throws std::invalid_argument if the capacity is zero or too large.
+template <typename T, bool MultiProducer, bool MultiConsumer> auto BoundedQueue<T, MultiProducer, MultiConsumer>::RoundCapacity(const size_t capacity) -> size_t {
+	if (capacity == 0 || capacity > SIZE_MAX / 2) {
+		throw std::invalid_argument("Queue capacity must be between 1 and SIZE_MAX / 2");
+	}
+	size_t rounded = 2;
+	while (rounded < capacity) {
+		rounded *= 2;
+	}
+	return rounded;
+}
+
+/// \brief Creates an empty queue.
+/// \param capacity The minimum number of elements the queue can hold.
+/// \throws std::invalid_argument if the capacity is zero or too large.
+template <typename T, bool MultiProducer, bool MultiConsumer> BoundedQueue<T, MultiProducer, MultiConsumer>::BoundedQueue(const size_t capacity) : mask_(RoundCapacity(capacity) - 1), slots_(std::make_unique<Slot[]>(mask_ + 1)) {
+	for (size_t i = 0; i <= mask_; ++i) {
+		slots_[i].sequence.store(i, std::memory_order_relaxed);
+	}
+}
+
+/// \brief Destroys the elements still in the queue.
+template <typename T, bool MultiProducer, bool MultiConsumer> BoundedQueue<T, MultiProducer, MultiConsumer>::~BoundedQueue() {
+	if constexpr (!std::is_trivially_destructible_v<T>) {
+		while (TryPop()) {}
+	}
+}
+
+/// \brief Constructs an element in place at the back of the queue.
+/// \param args The constructor arguments.
+/// \return true if the element was added, false if the queue is full.
+template <typename T, bool MultiProducer, bool MultiConsumer> template <typename... Args> auto BoundedQueue<T, MultiProducer, MultiConsumer>::TryEmplace(Args&&... args) -> bool {
+	size_t position = enqueuePosition_.load(std::memory_order_relaxed);
+	Slot* slot;
+	while (true) {
+		slot = &slots_[position & mask_];
+		const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+		const auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+		if (difference == 0) {
+			if constexpr (MultiProducer) {
+				if (enqueuePosition_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+			}
+			else {
+				enqueuePosition_.store(position + 1, std::memory_order_relaxed);
+				break;
+			}
+		}
+		else if (difference < 0) {
+			// The slot still holds the element of the previous lap: the queue is full.
+			return false;
+		}
+		else {
+			position = enqueuePosition_.load(std::memory_order_relaxed);
+		}
+	}
+	new (slot->storage) T(std::forward<Args>(args)...);
+	slot->sequence.store(position + 1, std::memory_order_release);
+	return true;
+}
+
+/// \brief Copies an element to the back of the queue.
+/// \return true if the element was added, false if the queue is full.
+template <typename T, bool MultiProducer, bool MultiConsumer> auto BoundedQueue<T, MultiProducer, MultiConsumer>::TryPush(const T& item) -> bool {
+	return TryEmplace(item);
+}
+
+/// \brief Moves an element to the back of the queue.
+/// \return true if the element was added, false if the queue is full; the element is left untouched then.
+template <typename T, bool MultiProducer, bool MultiConsumer> auto BoundedQueue<T, MultiProducer, MultiConsumer>::TryPush(T&& item) -> bool {
+	return TryEmplace(std::move(item));
+}
+
+/// \brief Removes the element at the front of the queue.
+/// \return The element, or std::nullopt if the queue is empty.
+template <typename T, bool MultiProducer, bool MultiConsumer> auto BoundedQueue<T, MultiProducer, MultiConsumer>::TryPop() -> std::optional<T> {
+	size_t position = dequeuePosition_.load(std::memory_order_relaxed);
+	Slot* slot;
+	while (true) {
+		slot = &slots_[position & mask_];
+		const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+		const auto difference = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+		if (difference == 0) {
+			if constexpr (MultiConsumer) {
+				if (dequeuePosition_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+			}
+			else {
+				dequeuePosition_.store(position + 1, std::memory_order_relaxed);
+				break;
+			}
+		}
+		else if (difference < 0) {
+			// The producer of this lap has not filled the slot yet: the queue is empty.
+			return std::nullopt;
+		}
+		else {
+			position = dequeuePosition_.load(std::memory_order_relaxed);
+		}
+	}
+	T* element = std::launder(reinterpret_cast<T*>(slot->storage));
+	std::optional<T> item(std::move(*element));
+	element->~T();
+	slot->sequence.store(position + mask_ + 1, std::memory_order_release);
+	return item;
+}
+
+/// \brief Returns the number of elements the queue can hold.
+template <typename T, bool MultiProducer, bool MultiConsumer> auto BoundedQueue<T, MultiProducer, MultiConsumer>::Capacity() const -> size_t {
+	return mask_ + 1;
+}
+
+/// \brief Returns the number of elements in the queue.
+/// \details The value is only a snapshot while other threads push or pop.
+template <typename T, bool MultiProducer, bool MultiConsumer> auto BoundedQueue<T, MultiProducer, MultiConsumer>::Size() const -> size_t {
+	const size_t dequeued = dequeuePosition_.load(std::memory_order_acquire);
+	const size_t enqueued = enqueuePosition_.load(std::memory_order_acquire);
+	return enqueued > dequeued ? enqueued - dequeued : 0;
+}
+
+/// \brief Returns whether the queue is empty.
+/// \details The value is only a snapshot while other threads push or pop.
+template <typename T, bool MultiProducer, bool MultiConsumer> auto BoundedQueue<T, MultiProducer, MultiConsumer>::Empty() const -> bool {
+	return Size() == 0;
+}
+}
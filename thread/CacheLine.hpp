@@ -0,0 +1,12 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#pragma once
+#include <cstddef>
+
+namespace common::thread
+{
+/// \brief Size in bytes used to pad data that is written concurrently by different threads.
+/// \details Members that are hammered by different cores are aligned to this boundary so that they
+/// do not share a cache line and invalidate each other (false sharing).
+inline constexpr size_t CACHE_LINE_SIZE = 64;
+}
@@ -0,0 +1,111 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#include "ClhMutex.hpp"
+#include <cstdint>
+#include "Backoff.hpp"
+
+namespace common::thread
+{
+/// \brief The node the calling thread will enqueue on its next lock, whichever ClhMutex that is.
+thread_local std::unique_ptr<ClhMutex::Node> ClhMutex::spareNode_;
+
+ClhMutex::ClhMutex() : tail_(Tagged(new Node)), owner_(nullptr), parked_(0), releases_(0) {}
+
+/// \details The lock must not be held, so the tail is the released node of the last owner.
+ClhMutex::~ClhMutex() {
+	delete Untagged(tail_.load());
+}
+
+/// \brief Marks a tail pointer as a released node that no thread is queued behind.
+/// \details Nodes are aligned to a cache line, so the lowest bit of their address is free.
+auto ClhMutex::Tagged(Node* node) -> Node* {
+	return reinterpret_cast<Node*>(reinterpret_cast<uintptr_t>(node) | 1);
+}
+
+/// \brief Strips the released tag from a tail pointer.
+auto ClhMutex::Untagged(Node* node) -> Node* {
+	return reinterpret_cast<Node*>(reinterpret_cast<uintptr_t>(node) & ~uintptr_t{1});
+}
+
+/// \brief Returns the spare node of the calling thread, allocating one if needed.
+auto ClhMutex::TakeSpareNode() -> Node* {
+	if (spareNode_) {
+		return spareNode_.release();
+	}
+	return new Node;
+}
+
+/// \brief Stores a node for the next lock of the calling thread.
+auto ClhMutex::KeepSpareNode(Node* node) -> void {
+	spareNode_.reset(node);
+}
+
+/// \brief Acquires the lock once every thread queued before has released it.
+auto ClhMutex::lock() -> void {
+	Node* node = TakeSpareNode();
+	node->locked.store(1, std::memory_order_relaxed);
+	Node* tail = tail_.exchange(node, std::memory_order_acq_rel);
+	Node* predecessor = Untagged(tail);
+	// A tagged tail was released without a successor, so its flag was never cleared and need not be.
+	if (tail == predecessor) {
+		Backoff backoff;
+		while (predecessor->locked.load(std::memory_order_acquire) != 0) {
+			if (backoff.Exhausted()) {
+				// Registering before reading the wake word and checking again means a release either sees
+				// this waiter and changes the word, or happened before the check.
+				parked_.fetch_add(1);
+				const uint32_t seen = releases_.load();
+				if (predecessor->locked.load() != 0) {
+					releases_.wait(seen);
+				}
+				parked_.fetch_sub(1);
+			}
+			else {
+				backoff.Pause();
+			}
+		}
+	}
+	// Nobody else references the predecessor's node any more; it becomes our spare.
+	KeepSpareNode(predecessor);
+	owner_ = node;
+}
+
+/// \brief Tries to acquire the lock without blocking.
+/// \details Succeeds only if the tail is a released node nobody is queued behind, so it never jumps the
+/// queue. Swapping the tagged tail for the own node checks and enqueues in one step; a recycled node
+/// that is the tail again carries the tag only once it has been released again, so the swap can never
+/// leave the thread waiting behind a holder.
+/// \return true if the lock was acquired, false otherwise.
+auto ClhMutex::try_lock() -> bool {
+	Node* tail = tail_.load(std::memory_order_relaxed);
+	if (tail != Tagged(Untagged(tail))) {
+		return false;
+	}
+	Node* node = TakeSpareNode();
+	node->locked.store(1, std::memory_order_relaxed);
+	if (!tail_.compare_exchange_strong(tail, node, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+		KeepSpareNode(node);
+		return false;
+	}
+	KeepSpareNode(Untagged(tail));
+	owner_ = node;
+	return true;
+}
+
+/// \brief Releases the lock, waking parked waiters if there are any.
+/// \details Without a successor the node stays the tail and is tagged as released, which needs no store to
+/// the node at all. Otherwise the store hands the node to the successor and is the last access to it; the
+/// wake-up only touches words of the mutex. The store and the load of the parked count are sequentially
+/// consistent, so either a waiter about to park sees the release or the release sees that waiter.
+auto ClhMutex::unlock() -> void {
+	Node* node = owner_;
+	if (tail_.compare_exchange_strong(node, Tagged(node), std::memory_order_release, std::memory_order_relaxed)) {
+		return;
+	}
+	owner_->locked.store(0);
+	if (parked_.load() != 0) {
+		releases_.fetch_add(1);
+		releases_.notify_all();
+	}
+}
+}
@@ -0,0 +1,49 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "CacheLine.hpp"
+
+namespace common::thread
+{
+/// \brief A fair queue lock after Craig, Landin and Hagersten.
+/// \details Waiters form an implicit queue: each thread appends a node of its own to the tail and spins
+/// on the node of its predecessor, so every waiter watches a different cache line and a release only
+/// touches the line of the next thread in line. The lock is granted in arrival order. After a spin budget
+/// a waiter parks on std::atomic::wait. Nodes are recycled between threads, each thread taking over the
+/// node of its predecessor, so locking does not allocate once every thread has its first node. Parked
+/// waiters sleep on a wake word of the mutex rather than on the node, because the node belongs to the
+/// successor as soon as it is released and may be recycled or freed before the release could notify it.
+/// An unlock without a successor tags the tail pointer as released, which lets try_lock() take the lock
+/// with a single compare-and-swap and never join the queue behind another thread. Prefer
+/// SpinlockMutex on oversubscribed machines, where handing the lock to a preempted waiter stalls the queue.
+class ClhMutex
+{
+public:
+	ClhMutex();
+	ClhMutex(const ClhMutex&) = delete;
+	auto operator=(const ClhMutex&) -> ClhMutex& = delete;
+	~ClhMutex();
+	auto lock() -> void;
+	auto try_lock() -> bool;
+	auto unlock() -> void;
+
+private:
+	struct alignas(CACHE_LINE_SIZE) Node
+	{
+		std::atomic<uint32_t> locked{0};
+	};
+
+	static auto Tagged(Node* node) -> Node*;
+	static auto Untagged(Node* node) -> Node*;
+	static auto TakeSpareNode() -> Node*;
+	static auto KeepSpareNode(Node* node) -> void;
+	static thread_local std::unique_ptr<Node> spareNode_;
+	alignas(CACHE_LINE_SIZE) std::atomic<Node*> tail_;
+	alignas(CACHE_LINE_SIZE) Node* owner_;
+	alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> parked_;
+	std::atomic<uint32_t> releases_;
+};
+}
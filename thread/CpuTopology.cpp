@@ -0,0 +1,175 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#include "CpuTopology.hpp"
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace common::thread
+{
+namespace
+{
+/// \brief Returns the CPUs the process is allowed to run on.
+auto AllowedCpus() -> std::vector<size_t> {
+	std::vector<size_t> cpus;
+#ifdef __linux__
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+		for (size_t cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+			if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+		}
+	}
+#endif
+	if (cpus.empty()) {
+		for (size_t cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); ++cpu) {
+			cpus.push_back(cpu);
+		}
+	}
+	return cpus;
+}
+}
+
+/// \brief Creates a topology from a list of nodes.
+/// \param nodes The nodes, each with at least one CPU.
+/// \throws std::invalid_argument if there is no node or a node has no CPU.
+CpuTopology::CpuTopology(std::vector<Node> nodes) : nodes_(std::move(nodes)) {
+	if (nodes_.empty()) {
+		throw std::invalid_argument("A CPU topology needs at least one node");
+	}
+	for (const Node& node : nodes_) {
+		if (node.cpus.empty()) {
+			throw std::invalid_argument("Every node of a CPU topology needs at least one CPU");
+		}
+	}
+}
+
+/// \brief Reads the topology of the machine.
+/// \details Nodes none of whose CPUs are usable by the process are left out.
+/// \return The topology, ordered by node id.
+auto CpuTopology::Discover() -> CpuTopology {
+	const std::vector<size_t> allowed = AllowedCpus();
+	std::vector<Node> nodes;
+	std::error_code error;
+	const std::filesystem::path root("/sys/devices/system/node");
+	for (const auto& entry : std::filesystem::directory_iterator(root, error)) {
+		const std::string name = entry.path().filename().string();
+		size_t id = 0;
+		if (name.rfind("node", 0) != 0 || std::from_chars(name.data() + 4, name.data() + name.size(), id).ec != std::errc()) continue;
+		std::ifstream file(entry.path() / "cpulist");
+		std::string list;
+		if (!std::getline(file, list)) continue;
+		Node node{id, {}};
+		for (const size_t cpu : ParseCpuList(list)) {
+			if (std::binary_search(allowed.begin(), allowed.end(), cpu)) node.cpus.push_back(cpu);
+		}
+		if (!node.cpus.empty()) nodes.push_back(std::move(node));
+	}
+	if (nodes.empty()) {
+		nodes.push_back({0, allowed});
+	}
+	std::ranges::sort(nodes, {}, &Node::id);
+	return CpuTopology(std::move(nodes));
+}
+
+/// \brief Returns the nodes of the topology.
+auto CpuTopology::GetNodes() const -> const std::vector<Node>& {
+	return nodes_;
+}
+
+/// \brief Returns every CPU of the topology, node by node.
+auto CpuTopology::GetCpus() const -> std::vector<size_t> {
+	std::vector<size_t> cpus;
+	for (const Node& node : nodes_) {
+		cpus.insert(cpus.end(), node.cpus.begin(), node.cpus.end());
+	}
+	return cpus;
+}
+
+/// \brief Returns the position in GetNodes of the node a CPU belongs to.
+/// \param cpu The CPU number.
+/// \return The node index, or std::nullopt if the CPU is not part of the topology.
+auto CpuTopology::NodeOfCpu(const size_t cpu) const -> std::optional<size_t> {
+	for (size_t i = 0; i < nodes_.size(); ++i) {
+		if (std::ranges::find(nodes_[i].cpus, cpu) != nodes_[i].cpus.end()) return i;
+	}
+	return std::nullopt;
+}
+
+/// \brief Parses a CPU list in the kernel's format, such as "0-3,8,10-11".
+/// \param list The list.
+/// \return The CPUs, sorted and without duplicates.
+/// \throws std::invalid_argument if the list is malformed.
+auto CpuTopology::ParseCpuList(const std::string_view list) -> std::vector<size_t> {
+	std::vector<size_t> cpus;
+	const char* position = list.data();
+	const char* const end = list.data() + list.size();
+	const auto skipSpace = [&] {
+		while (position != end && (*position == ' ' || *position == '\n')) ++position;
+	};
+	skipSpace();
+	while (position != end) {
+		size_t first = 0;
+		auto result = std::from_chars(position, end, first);
+		if (result.ec != std::errc()) {
+			throw std::invalid_argument("Malformed CPU list");
+		}
+		size_t last = first;
+		if (result.ptr != end && *result.ptr == '-') {
+			result = std::from_chars(result.ptr + 1, end, last);
+			if (result.ec != std::errc() || last < first) {
+				throw std::invalid_argument("Malformed CPU list");
+			}
+		}
+		for (size_t cpu = first; cpu <= last; ++cpu) {
+			cpus.push_back(cpu);
+		}
+		position = result.ptr;
+		skipSpace();
+		if (position != end) {
+			if (*position != ',') {
+				throw std::invalid_argument("Malformed CPU list");
+			}
+			++position;
+		}
+	}
+	std::ranges::sort(cpus);
+	cpus.erase(std::ranges::unique(cpus).begin(), cpus.end());
+	return cpus;
+}
+
+/// \brief Returns the CPU the calling thread is running on.
+/// \return The CPU number, or std::nullopt where it cannot be determined.
+auto CpuTopology::CurrentCpu() -> std::optional<size_t> {
+#ifdef __linux__
+	if (const int cpu = sched_getcpu(); cpu >= 0) return static_cast<size_t>(cpu);
+#endif
+	return std::nullopt;
+}
+
+/// \brief Restricts a thread to a set of CPUs.
+/// \param thread The thread, which must be running.
+/// \param cpus The CPUs it may run on.
+/// \return true on success, false if the set is empty or invalid, or affinity is not supported.
+auto CpuTopology::SetThreadAffinity(std::thread& thread, const std::vector<size_t>& cpus) -> bool {
+#ifdef __linux__
+	if (cpus.empty() || !thread.joinable()) return false;
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (const size_t cpu : cpus) {
+		if (cpu >= CPU_SETSIZE) return false;
+		CPU_SET(cpu, &set);
+	}
+	return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) == 0;
+#else
+	return false;
+#endif
+}
+}
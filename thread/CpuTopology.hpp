@@ -0,0 +1,37 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#pragma once
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace common::thread
+{
+/// \brief The CPUs and NUMA nodes the process may run on.
+/// \details On Linux the topology is read from /sys/devices/system/node and restricted to the CPUs
+/// in the affinity mask of the process, so it honours taskset and cgroup cpusets. Machines without
+/// NUMA information, and other platforms, are described as a single node holding every CPU.
+class CpuTopology
+{
+public:
+	/// \brief A NUMA node and the usable CPUs attached to it.
+	struct Node
+	{
+		size_t id;
+		std::vector<size_t> cpus;
+	};
+
+	explicit CpuTopology(std::vector<Node> nodes);
+	static auto Discover() -> CpuTopology;
+	[[nodiscard]] auto GetNodes() const -> const std::vector<Node>&;
+	[[nodiscard]] auto GetCpus() const -> std::vector<size_t>;
+	[[nodiscard]] auto NodeOfCpu(size_t cpu) const -> std::optional<size_t>;
+	static auto ParseCpuList(std::string_view list) -> std::vector<size_t>;
+	static auto CurrentCpu() -> std::optional<size_t>;
+	static auto SetThreadAffinity(std::thread& thread, const std::vector<size_t>& cpus) -> bool;
+
+private:
+	std::vector<Node> nodes_;
+};
+}
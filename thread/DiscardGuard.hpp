@@ -0,0 +1,42 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#pragma once
+#include <type_traits>
+#include <utility>
+
+namespace common::thread
+{
+/// \brief Runs a callback when the task owning it is destroyed without having been run.
+/// \details A task given to ThreadPool::Execute has no future that could report a broken promise, so
+/// a task the pool rejects, drops under the DiscardOldest rejection policy or throws away in ShutdownNow
+/// is lost silently. Capturing a guard in such a task and dismissing it when the task starts lets the
+/// submitter release whatever the task would have. The callback runs on the thread that destroys the
+/// task, possibly inside Execute or ShutdownNow, and must not throw. Moving a guard transfers the duty.
+/// \tparam F The callback, callable without arguments.
+template <class F> class DiscardGuard final
+{
+public:
+	explicit DiscardGuard(F onDiscard) noexcept(std::is_nothrow_move_constructible_v<F>) : onDiscard_(std::move(onDiscard)) {}
+
+	DiscardGuard(DiscardGuard&& other) noexcept(std::is_nothrow_move_constructible_v<F>) : onDiscard_(std::move(other.onDiscard_)), armed_(std::exchange(other.armed_, false)) {}
+
+	DiscardGuard(const DiscardGuard&) = delete;
+	auto operator=(const DiscardGuard&) -> DiscardGuard& = delete;
+	auto operator=(DiscardGuard&&) -> DiscardGuard& = delete;
+
+	~DiscardGuard() {
+		if (armed_) {
+			onDiscard_();
+		}
+	}
+
+	/// \brief Marks the task as run, so the callback is not called.
+	auto Dismiss() noexcept -> void {
+		armed_ = false;
+	}
+
+private:
+	F onDiscard_;
+	bool armed_{true};
+};
+}
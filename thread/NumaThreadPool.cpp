@@ -0,0 +1,56 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#include "NumaThreadPool.hpp"
+
+namespace common::thread
+{
+/// \brief Creates one sub-pool per node of a topology.
+/// \param topology The nodes and CPUs to use, usually CpuTopology::Discover().
+/// \param queue_size The task queue capacity of each sub-pool.
+/// \param idle_time How long an idle worker waits before it may retire.
+/// \param mode The scheduling mode of each sub-pool.
+/// \param affinity Whether each worker is pinned to one CPU of its node or to the whole node.
+NumaThreadPool::NumaThreadPool(const CpuTopology& topology, const size_t queue_size, const std::chrono::milliseconds idle_time, const ThreadPool::SchedulingMode mode, const ThreadPool::AffinityMode affinity) : topology_(topology), nextNode_(0) {
+	for (const auto& node : topology_.GetNodes()) {
+		auto pool = std::make_unique<ThreadPool>(node.cpus.size(), node.cpus.size(), queue_size, idle_time, mode);
+		pool->SetWorkerAffinity(node.cpus, affinity);
+		pools_.push_back(std::move(pool));
+	}
+}
+
+/// \brief Shuts every sub-pool down, finishing the queued tasks.
+auto NumaThreadPool::Shutdown() -> void {
+	for (const auto& pool : pools_) {
+		pool->Shutdown();
+	}
+}
+
+/// \brief Returns the node of the CPU the calling thread runs on.
+/// \details Falls back to the nodes in turn when the CPU is unknown or outside the topology.
+auto NumaThreadPool::LocalNode() const -> size_t {
+	if (const auto cpu = CpuTopology::CurrentCpu()) {
+		if (const auto node = topology_.NodeOfCpu(*cpu)) return *node;
+	}
+	return nextNode_.fetch_add(1, std::memory_order_relaxed) % pools_.size();
+}
+
+/// \brief Returns the number of nodes, and thus sub-pools.
+auto NumaThreadPool::GetNodeCount() const -> size_t {
+	return pools_.size();
+}
+
+/// \brief Returns the sub-pool of a node.
+/// \param node The index of the node in the topology.
+/// \throws std::out_of_range if the node does not exist.
+auto NumaThreadPool::GetPool(const size_t node) -> ThreadPool& {
+	if (node >= pools_.size()) {
+		throw std::out_of_range("NUMA node index out of range");
+	}
+	return *pools_[node];
+}
+
+/// \brief Returns the topology the pool was built from.
+auto NumaThreadPool::GetTopology() const -> const CpuTopology& {
+	return topology_;
+}
+}
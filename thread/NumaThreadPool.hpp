@@ -0,0 +1,85 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <vector>
+#include "CpuTopology.hpp"
+#include "ThreadPool.hpp"
+
+namespace common::thread
+{
+/// \brief A thread pool split into one sub-pool per NUMA node.
+/// \details Every sub-pool has its own queues and as many workers as its node has CPUs, all pinned to
+/// that node, so a task runs next to the memory it allocates and queue traffic stays within a socket.
+/// Submit sends a task to the node of the calling thread, which keeps work spawned by a task on the
+/// same node; SubmitOn takes the node as a locality hint, typically the node that holds the data the
+/// task will touch. Threads whose node is unknown are spread over the nodes in turn.
+class NumaThreadPool
+{
+public:
+	NumaThreadPool(const CpuTopology& topology, size_t queue_size, std::chrono::milliseconds idle_time, ThreadPool::SchedulingMode mode = ThreadPool::SchedulingMode::WorkStealing, ThreadPool::AffinityMode affinity = ThreadPool::AffinityMode::CpuSet);
+	template <class F, class... Args> auto Submit(F&& f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>>;
+	template <class F, class... Args> auto SubmitOn(size_t node, F&& f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>>;
+	template <class F, class... Args> auto Execute(F&& f, Args&&... args) -> void;
+	template <class F, class... Args> auto ExecuteOn(size_t node, F&& f, Args&&... args) -> void;
+	auto Shutdown() -> void;
+	[[nodiscard]] auto LocalNode() const -> size_t;
+	[[nodiscard]] auto GetNodeCount() const -> size_t;
+	[[nodiscard]] auto GetPool(size_t node) -> ThreadPool&;
+	[[nodiscard]] auto GetTopology() const -> const CpuTopology&;
+
+private:
+	CpuTopology topology_;
+	std::vector<std::unique_ptr<ThreadPool>> pools_;
+	mutable std::atomic<size_t> nextNode_;
+};
+
+/// \brief Submit a task to the sub-pool of the calling thread's node.
+/// \tparam F The type of the function to be executed.
+/// \tparam Args The types of the arguments to be passed to the function.
+/// \param f The function to be executed.
+/// \param args The arguments to be passed to the function.
+/// \return A future object that will hold the result of the function execution.
+/// \throws std::runtime_error if the sub-pool rejects the task.
+template <class F, class... Args> auto NumaThreadPool::Submit(F&& f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>> {
+	return pools_[LocalNode()]->Submit(std::forward<F>(f), std::forward<Args>(args)...);
+}
+
+/// \brief Submit a task to the sub-pool of a given node.
+/// \tparam F The type of the function to be executed.
+/// \tparam Args The types of the arguments to be passed to the function.
+/// \param node The index of the node in the topology.
+/// \param f The function to be executed.
+/// \param args The arguments to be passed to the function.
+/// \return A future object that will hold the result of the function execution.
+/// \throws std::out_of_range if the node does not exist.
+/// \throws std::runtime_error if the sub-pool rejects the task.
+template <class F, class... Args> auto NumaThreadPool::SubmitOn(const size_t node, F&& f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>> {
+	return GetPool(node).Submit(std::forward<F>(f), std::forward<Args>(args)...);
+}
+
+/// \brief Execute a task on the sub-pool of the calling thread's node without tracking its result.
+/// \tparam F The type of the function to be executed.
+/// \tparam Args The types of the arguments to be passed to the function.
+/// \param f The function to be executed.
+/// \param args The arguments to be passed to the function.
+/// \throws std::runtime_error if the sub-pool rejects the task.
+template <class F, class... Args> auto NumaThreadPool::Execute(F&& f, Args&&... args) -> void {
+	pools_[LocalNode()]->Execute(std::forward<F>(f), std::forward<Args>(args)...);
+}
+
+/// \brief Execute a task on the sub-pool of a given node without tracking its result.
+/// \tparam F The type of the function to be executed.
+/// \tparam Args The types of the arguments to be passed to the function.
+/// \param node The index of the node in the topology.
+/// \param f The function to be executed.
+/// \param args The arguments to be passed to the function.
+/// \throws std::out_of_range if the node does not exist.
+/// \throws std::runtime_error if the sub-pool rejects the task.
+template <class F, class... Args> auto NumaThreadPool::ExecuteOn(const size_t node, F&& f, Args&&... args) -> void {
+	GetPool(node).Execute(std::forward<F>(f), std::forward<Args>(args)...);
+}
+}
@@ -0,0 +1,258 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <vector>
+#include "ThreadPool.hpp"
+
+namespace common::thread
+{
+/// \brief Data-parallel algorithms running on a ThreadPool.
+/// \details Every algorithm splits its index range into chunks that are claimed dynamically by the calling
+/// thread and by helper tasks submitted to the pool. Chunk sizes follow guided self-scheduling: each claim
+/// takes a fraction of what is left, so chunks start large and shrink towards the grain size as the range
+/// drains, which keeps the participants balanced even when the cost per index is irregular. The calling
+/// thread always takes part and only returns once every chunk has finished, so the algorithms may be nested
+/// and called from inside pool workers without deadlocking. The first exception thrown by a chunk stops the
+/// remaining chunks and is rethrown to the caller.
+class ParallelUtil abstract
+{
+public:
+	template <class F> static auto ParallelFor(ThreadPool& pool, size_t begin, size_t end, F&& func) -> void;
+	template <class F> static auto ParallelFor(ThreadPool& pool, size_t begin, size_t end, size_t grainSize, F&& func) -> void;
+	template <class RandomIt, class T, class BinaryOp> static auto ParallelReduce(ThreadPool& pool, RandomIt first, RandomIt last, T identity, BinaryOp op) -> T;
+	template <class RandomIt, class OutputIt, class UnaryOp> static auto ParallelTransform(ThreadPool& pool, RandomIt first, RandomIt last, OutputIt dFirst, UnaryOp op) -> OutputIt;
+	template <class RandomIt, class Compare = std::less<>> static auto ParallelSort(ThreadPool& pool, RandomIt first, RandomIt last, Compare comp = {}) -> void;
+
+private:
+	static constexpr size_t CHUNKS_PER_PARTICIPANT = 64;
+	static constexpr size_t GUIDED_DIVISOR = 4;
+	static constexpr size_t SEQUENTIAL_SORT_THRESHOLD = 8192;
+	static auto ParticipantCount(const ThreadPool& pool, size_t count, size_t grainSize, size_t maxParticipants) -> size_t;
+	template <class Body> static auto RunChunks(ThreadPool& pool, size_t begin, size_t end, size_t grainSize, size_t maxParticipants, Body&& body) -> void;
+};
+
+/// \brief Returns how many threads, the caller included, should work on a range.
+/// \param pool The pool providing the helpers.
+/// \param count The number of indices.
+/// \param grainSize The minimum chunk size.
+/// \param maxParticipants An upper bound imposed by the caller.
+inline auto ParallelUtil::ParticipantCount(const ThreadPool& pool, const size_t count, const size_t grainSize, const size_t maxParticipants) -> size_t {
+	const size_t maxChunks = (count + grainSize - 1) / grainSize;
+	return std::max<size_t>(1, std::min({pool.GetPoolSize() + 1, maxChunks, maxParticipants}));
+}
+
+/// \brief Runs a chunk body over [begin, end) on the caller and on helper tasks of the pool.
+/// \tparam Body Callable as body(chunkBegin, chunkEnd, participant), participant being in [0, participants).
+/// \param pool The pool providing the helpers.
+/// \param begin The first index.
+/// \param end One past the last index.
+/// \param grainSize The minimum chunk size, 0 to select it from the range and pool size.
+/// \param maxParticipants An upper bound on the number of participants.
+/// \param body The chunk body; it is only referenced while the call is in progress.
+template <class Body> auto ParallelUtil::RunChunks(ThreadPool& pool, const size_t begin, const size_t end, size_t grainSize, const size_t maxParticipants, Body&& body) -> void {
+	if (begin >= end) return;
+	const size_t count = end - begin;
+	if (grainSize == 0) {
+		grainSize = std::max<size_t>(1, count / ((pool.GetPoolSize() + 1) * CHUNKS_PER_PARTICIPANT));
+	}
+	const size_t participants = ParticipantCount(pool, count, grainSize, maxParticipants);
+	if (participants == 1) {
+		body(begin, end, size_t{0});
+		return;
+	}
+
+	struct LoopState
+	{
+		LoopState(const size_t begin, const size_t end, const size_t grainSize, const size_t participants, std::remove_reference_t<Body>* body) : next(begin), remaining(end - begin), end(end), grainSize(grainSize), participants(participants), body(body) {}
+
+		/// \brief Claims the next chunk, or returns false once the range is exhausted.
+		auto Claim(size_t& chunkBegin, size_t& chunkEnd) -> bool {
+			size_t current = next.load();
+			while (current < end) {
+				const size_t left = end - current;
+				const size_t chunk = std::min(left, std::max(grainSize, left / (participants * GUIDED_DIVISOR)));
+				if (next.compare_exchange_weak(current, current + chunk)) {
+					chunkBegin = current;
+					chunkEnd = current + chunk;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/// \brief Marks \p count indices as done and wakes the caller after the last one.
+		auto Complete(const size_t count) -> void {
+			if (remaining.fetch_sub(count) == count) {
+				remaining.notify_all();
+			}
+		}
+
+		/// \brief Processes chunks until none is left.
+		auto Run(const size_t participant) -> void {
+			size_t chunkBegin = 0;
+			size_t chunkEnd = 0;
+			while (Claim(chunkBegin, chunkEnd)) {
+				try {
+					(*body)(chunkBegin, chunkEnd, participant);
+				}
+				catch (...) {
+					if (!failed.exchange(true)) {
+						error = std::current_exception();
+					}
+					if (const size_t claimed = next.exchange(end); claimed < end) {
+						Complete(end - claimed);
+					}
+				}
+				Complete(chunkEnd - chunkBegin);
+			}
+		}
+
+		std::atomic<size_t> next;
+		std::atomic<size_t> remaining;
+		std::atomic<bool> failed{false};
+		std::exception_ptr error;
+		size_t end;
+		size_t grainSize;
+		size_t participants;
+		std::remove_reference_t<Body>* body;
+	};
+
+	auto state = std::allocate_shared<LoopState>(PooledAllocator<LoopState>(), begin, end, grainSize, participants, &body);
+	for (size_t participant = 1; participant < participants; ++participant) {
+		try {
+			pool.Execute([state, participant] {
+				state->Run(participant);
+			});
+		}
+		catch (const std::runtime_error&) {
+			// The pool cannot take more work right now; the caller and the helpers already queued finish the range.
+			break;
+		}
+	}
+	state->Run(0);
+	for (size_t left = state->remaining.load(); left != 0; left = state->remaining.load()) {
+		state->remaining.wait(left);
+	}
+	if (state->failed) {
+		std::rethrow_exception(state->error);
+	}
+}
+
+/// \brief Calls a function for every index of a range in parallel.
+/// \tparam F The type of the function, callable with a size_t index.
+/// \param pool The pool providing the helper threads.
+/// \param begin The first index.
+/// \param end One past the last index.
+/// \param func The function to call.
+/// \details The grain size is selected from the length of the range and the size of the pool.
+template <class F> auto ParallelUtil::ParallelFor(ThreadPool& pool, const size_t begin, const size_t end, F&& func) -> void {
+	ParallelFor(pool, begin, end, 0, std::forward<F>(func));
+}
+
+/// \brief Calls a function for every index of a range in parallel.
+/// \tparam F The type of the function, callable with a size_t index.
+/// \param pool The pool providing the helper threads.
+/// \param begin The first index.
+/// \param end One past the last index.
+/// \param grainSize The minimum number of indices a thread claims at once, 0 to select it automatically.
+/// \param func The function to call.
+template <class F> auto ParallelUtil::ParallelFor(ThreadPool& pool, const size_t begin, const size_t end, const size_t grainSize, F&& func) -> void {
+	RunChunks(pool, begin, end, grainSize, SIZE_MAX, [&func](const size_t chunkBegin, const size_t chunkEnd, size_t) {
+		for (size_t i = chunkBegin; i < chunkEnd; ++i) {
+			std::invoke(func, i);
+		}
+	});
+}
+
+/// \brief Reduces a range in parallel.
+/// \tparam RandomIt A random access iterator.
+/// \tparam T The type of the result.
+/// \tparam BinaryOp The type of the reduction operation.
+/// \param pool The pool providing the helper threads.
+/// \param first The first element.
+/// \param last One past the last element.
+/// \param identity The initial value, combined exactly once into the result.
+/// \param op The reduction operation. Like std::reduce, it must be associative and commutative
+/// because partial results are combined in an unspecified order.
+/// \return The reduction of identity and every element of the range.
+template <class RandomIt, class T, class BinaryOp> auto ParallelUtil::ParallelReduce(ThreadPool& pool, RandomIt first, RandomIt last, T identity, BinaryOp op) -> T {
+	const auto count = static_cast<size_t>(std::distance(first, last));
+	std::vector<std::optional<T>> partials(pool.GetPoolSize() + 1);
+	RunChunks(pool, 0, count, 0, partials.size(), [&](const size_t chunkBegin, const size_t chunkEnd, const size_t participant) {
+		T accumulator = first[chunkBegin];
+		for (size_t i = chunkBegin + 1; i < chunkEnd; ++i) {
+			accumulator = op(std::move(accumulator), first[i]);
+		}
+		auto& partial = partials[participant];
+		partial = partial ? op(std::move(*partial), std::move(accumulator)) : std::move(accumulator);
+	});
+	for (auto& partial : partials) {
+		if (partial) {
+			identity = op(std::move(identity), std::move(*partial));
+		}
+	}
+	return identity;
+}
+
+/// \brief Applies a function to every element of a range in parallel and stores the results.
+/// \tparam RandomIt A random access iterator.
+/// \tparam OutputIt A random access output iterator.
+/// \tparam UnaryOp The type of the function.
+/// \param pool The pool providing the helper threads.
+/// \param first The first element.
+/// \param last One past the last element.
+/// \param dFirst The first element of the destination range, which may be first itself.
+/// \param op The function to apply.
+/// \return An iterator one past the last element written.
+template <class RandomIt, class OutputIt, class UnaryOp> auto ParallelUtil::ParallelTransform(ThreadPool& pool, RandomIt first, RandomIt last, OutputIt dFirst, UnaryOp op) -> OutputIt {
+	const auto count = static_cast<size_t>(std::distance(first, last));
+	RunChunks(pool, 0, count, 0, SIZE_MAX, [&](const size_t chunkBegin, const size_t chunkEnd, size_t) {
+		for (size_t i = chunkBegin; i < chunkEnd; ++i) {
+			dFirst[i] = op(first[i]);
+		}
+	});
+	return dFirst + static_cast<std::ptrdiff_t>(count);
+}
+
+/// \brief Sorts a range in parallel with a merge sort.
+/// \tparam RandomIt A random access iterator.
+/// \tparam Compare The type of the comparison.
+/// \param pool The pool providing the helper threads.
+/// \param first The first element.
+/// \param last One past the last element.
+/// \param comp The comparison, as for std::sort.
+/// \details The range is cut into a power-of-two number of runs that are sorted concurrently with
+/// std::sort, then neighbouring runs are merged pairwise, all pairs of a level in parallel. Small
+/// ranges are sorted sequentially. Like std::sort, the sort is not stable.
+template <class RandomIt, class Compare> auto ParallelUtil::ParallelSort(ThreadPool& pool, RandomIt first, RandomIt last, Compare comp) -> void {
+	const auto count = static_cast<size_t>(std::distance(first, last));
+	if (count < SEQUENTIAL_SORT_THRESHOLD || pool.GetPoolSize() == 0) {
+		std::sort(first, last, comp);
+		return;
+	}
+	size_t runs = 1;
+	while (runs < 2 * (pool.GetPoolSize() + 1) && count / (runs * 2) >= SEQUENTIAL_SORT_THRESHOLD / 2) {
+		runs *= 2;
+	}
+	const auto boundary = [count, runs](const size_t run) {
+		return static_cast<std::ptrdiff_t>(std::min(count, run * ((count + runs - 1) / runs)));
+	};
+	ParallelFor(pool, 0, runs, 1, [&](const size_t run) {
+		std::sort(first + boundary(run), first + boundary(run + 1), comp);
+	});
+	for (size_t width = 1; width < runs; width *= 2) {
+		ParallelFor(pool, 0, runs / (2 * width), 1, [&](const size_t pair) {
+			const size_t left = pair * 2 * width;
+			std::inplace_merge(first + boundary(left), first + boundary(left + width), first + boundary(left + 2 * width), comp);
+		});
+	}
+}
+}
@@ -0,0 +1,110 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#include "PooledAllocator.hpp"
+
+namespace common::thread
+{
+/// \brief Releases every block still cached when the owning thread exits.
+BlockCache::FreeLists::~FreeLists() {
+	for (FreeBlock*& head : heads) {
+		FreeChain(head);
+		head = nullptr;
+	}
+}
+
+/// \brief Releases every batch left in the depot at program exit.
+BlockCache::Depot::~Depot() {
+	for (const auto& classBatches : batches) {
+		for (FreeBlock* batch : classBatches) {
+			FreeChain(batch);
+		}
+	}
+}
+
+/// \brief Allocates a block of at least \p size bytes.
+/// \details Reuses a cached block of the same size class when the calling thread has one.
+/// \param size The number of bytes required.
+/// \return A pointer to uninitialized storage aligned for any fundamental type.
+auto BlockCache::Allocate(const size_t size) -> void* {
+	if (size == 0 || size > MAX_BLOCK_SIZE) {
+		return ::operator new(size);
+	}
+	const size_t index = (size - 1) / GRANULARITY;
+	FreeLists& lists = LocalFreeLists();
+	if (!lists.heads[index]) {
+		Depot& depot = SharedDepot();
+		std::lock_guard lock(depot.mutex);
+		if (auto& classBatches = depot.batches[index]; !classBatches.empty()) {
+			lists.heads[index] = classBatches.back();
+			lists.counts[index] = BATCH_SIZE;
+			classBatches.pop_back();
+		}
+	}
+	if (FreeBlock* block = lists.heads[index]) {
+		lists.heads[index] = block->next;
+		--lists.counts[index];
+		return block;
+	}
+	return ::operator new((index + 1) * GRANULARITY);
+}
+
+/// \brief Returns a block to the calling thread's cache.
+/// \details When the cache is full a batch of blocks moves to the shared depot.
+/// \param block The block returned by Allocate.
+/// \param size The size passed to Allocate.
+auto BlockCache::Deallocate(void* block, const size_t size) -> void {
+	if (!block) {
+		return;
+	}
+	if (size == 0 || size > MAX_BLOCK_SIZE) {
+		::operator delete(block);
+		return;
+	}
+	const size_t index = (size - 1) / GRANULARITY;
+	FreeLists& lists = LocalFreeLists();
+	lists.heads[index] = new(block) FreeBlock{lists.heads[index]};
+	++lists.counts[index];
+	if (lists.counts[index] < MAX_CACHED_BLOCKS) {
+		return;
+	}
+	FreeBlock* batch = lists.heads[index];
+	FreeBlock* last = batch;
+	for (size_t i = 1; i < BATCH_SIZE; ++i) {
+		last = last->next;
+	}
+	lists.heads[index] = last->next;
+	lists.counts[index] -= BATCH_SIZE;
+	last->next = nullptr;
+	{
+		Depot& depot = SharedDepot();
+		std::lock_guard lock(depot.mutex);
+		if (depot.batches[index].size() < MAX_DEPOT_BATCHES) {
+			depot.batches[index].push_back(batch);
+			return;
+		}
+	}
+	FreeChain(batch);
+}
+
+/// \brief Returns the free lists of the calling thread.
+auto BlockCache::LocalFreeLists() -> FreeLists& {
+	thread_local FreeLists lists;
+	return lists;
+}
+
+/// \brief Returns the depot shared by all threads.
+auto BlockCache::SharedDepot() -> Depot& {
+	static Depot depot;
+	return depot;
+}
+
+/// \brief Releases a chain of free blocks to operator delete.
+/// \param head The first block of the chain.
+auto BlockCache::FreeChain(FreeBlock* head) -> void {
+	while (head) {
+		FreeBlock* next = head->next;
+		::operator delete(head);
+		head = next;
+	}
+}
+}
@@ -0,0 +1,102 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#pragma once
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace common::thread
+{
+/// \brief A per-thread cache of small memory blocks.
+/// \details Blocks are grouped in size classes of GRANULARITY bytes. A freed block goes to the free list of
+/// the thread that frees it and is handed out again by the next allocation of the same size class on that
+/// thread. Producer/consumer patterns allocate on one thread and free on another, so a thread whose list
+/// grows past MAX_CACHED_BLOCKS hands a batch of BATCH_SIZE blocks to a shared depot, and a thread whose
+/// list is empty takes a batch back before falling back to operator new. Steady-state allocate/free cycles
+/// therefore touch the global allocator rarely and the depot mutex once per batch. Requests larger than
+/// MAX_BLOCK_SIZE go straight to operator new/delete.
+class BlockCache final
+{
+public:
+	static auto Allocate(size_t size) -> void*;
+	static auto Deallocate(void* block, size_t size) -> void;
+
+private:
+	static constexpr size_t GRANULARITY = 16;
+	static constexpr size_t MAX_BLOCK_SIZE = 512;
+	static constexpr size_t CLASS_COUNT = MAX_BLOCK_SIZE / GRANULARITY;
+	static constexpr size_t MAX_CACHED_BLOCKS = 256;
+	static constexpr size_t BATCH_SIZE = 64;
+	static constexpr size_t MAX_DEPOT_BATCHES = 1024;
+
+	struct FreeBlock
+	{
+		FreeBlock* next;
+	};
+
+	struct FreeLists
+	{
+		std::array<FreeBlock*, CLASS_COUNT> heads{};
+		std::array<size_t, CLASS_COUNT> counts{};
+		~FreeLists();
+	};
+
+	struct Depot
+	{
+		std::mutex mutex;
+		std::array<std::vector<FreeBlock*>, CLASS_COUNT> batches;
+		~Depot();
+	};
+
+	static auto LocalFreeLists() -> FreeLists&;
+	static auto SharedDepot() -> Depot&;
+	static auto FreeChain(FreeBlock* head) -> void;
+};
+
+/// \brief A standard allocator that serves small allocations from the calling thread's BlockCache.
+/// \tparam T The value type.
+/// \details The allocator is stateless, so every instance compares equal and memory allocated on one
+/// thread may be released on another. Over-aligned types bypass the cache.
+template <typename T> class PooledAllocator
+{
+public:
+	using value_type = T;
+	PooledAllocator() noexcept = default;
+	template <typename U> explicit PooledAllocator(const PooledAllocator<U>&) noexcept {}
+	[[nodiscard]] auto allocate(size_t n) -> T*;
+	auto deallocate(T* p, size_t n) noexcept -> void;
+	template <typename U> auto operator==(const PooledAllocator<U>&) const noexcept -> bool;
+};
+
+/// \brief Allocates storage for \p n objects of type T.
+/// \param n The number of objects.
+/// \return A pointer to uninitialized storage.
+template <typename T> auto PooledAllocator<T>::allocate(const size_t n) -> T* {
+	if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+		return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+	}
+	else {
+		return static_cast<T*>(BlockCache::Allocate(n * sizeof(T)));
+	}
+}
+
+/// \brief Releases storage obtained from allocate.
+/// \param p The pointer returned by allocate.
+/// \param n The number of objects passed to allocate.
+template <typename T> auto PooledAllocator<T>::deallocate(T* p, const size_t n) noexcept -> void {
+	if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+		::operator delete(p, std::align_val_t{alignof(T)});
+	}
+	else {
+		BlockCache::Deallocate(p, n * sizeof(T));
+	}
+}
+
+/// \brief All pooled allocators are interchangeable.
+/// \return Always true.
+template <typename T> template <typename U> auto PooledAllocator<T>::operator==(const PooledAllocator<U>&) const noexcept -> bool {
+	return true;
+}
+}
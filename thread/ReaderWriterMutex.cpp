@@ -0,0 +1,120 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#include "ReaderWriterMutex.hpp"
+#include <functional>
+#include <thread>
+#include "Backoff.hpp"
+
+namespace common::thread
+{
+ReaderWriterMutex::ReaderWriterMutex() : writer_(0) {}
+
+/// \brief Returns the reader shard of the calling thread.
+/// \details The shard is fixed per thread because unlock_shared has to find the counter lock_shared
+/// incremented, even if the thread has migrated to another core in between.
+auto ReaderWriterMutex::ShardIndex() -> size_t {
+	thread_local const size_t index = std::hash<std::thread::id>{}(std::this_thread::get_id()) % SHARD_COUNT;
+	return index;
+}
+
+/// \brief Acquires the lock exclusively.
+/// \details Claims the writer flag first, which stops new readers, then waits for the readers that
+/// are already inside to leave.
+auto ReaderWriterMutex::lock() -> void {
+	Backoff backoff;
+	for (uint32_t expected = 0; !writer_.compare_exchange_weak(expected, 1, std::memory_order_seq_cst, std::memory_order_relaxed); expected = 0) {
+		if (backoff.Exhausted()) {
+			writer_.wait(1, std::memory_order_relaxed);
+		}
+		else {
+			backoff.Pause();
+		}
+	}
+	WaitForReaders();
+}
+
+/// \brief Tries to acquire the lock exclusively without blocking.
+/// \return true if the lock was acquired, false if it is held in any mode.
+auto ReaderWriterMutex::try_lock() -> bool {
+	uint32_t expected = 0;
+	if (!writer_.compare_exchange_strong(expected, 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+		return false;
+	}
+	for (auto& shard : shards_) {
+		if (shard.readers.load(std::memory_order_seq_cst) != 0) {
+			unlock();
+			return false;
+		}
+	}
+	return true;
+}
+
+/// \brief Releases the exclusive lock and wakes the threads waiting for it.
+auto ReaderWriterMutex::unlock() -> void {
+	writer_.store(0, std::memory_order_release);
+	writer_.notify_all();
+}
+
+/// \brief Acquires the lock shared, waiting while a writer holds or waits for it.
+auto ReaderWriterMutex::lock_shared() -> void {
+	ReaderShard& shard = shards_[ShardIndex()];
+	Backoff backoff;
+	while (!TryEnterShared(shard)) {
+		if (backoff.Exhausted()) {
+			writer_.wait(1, std::memory_order_relaxed);
+		}
+		else {
+			backoff.Pause();
+		}
+	}
+}
+
+/// \brief Tries to acquire the lock shared without blocking.
+/// \return true if the lock was acquired, false if a writer holds or waits for it.
+auto ReaderWriterMutex::try_lock_shared() -> bool {
+	return TryEnterShared(shards_[ShardIndex()]);
+}
+
+/// \brief Releases a shared lock.
+auto ReaderWriterMutex::unlock_shared() -> void {
+	LeaveShared(shards_[ShardIndex()]);
+}
+
+/// \brief Registers a reader unless a writer is present.
+/// \details The increment and the load of the writer flag pair up with the store of the flag and the
+/// loads of the shards in lock, all sequentially consistent: either the reader sees the writer and
+/// backs out, or the writer sees the reader and waits for it.
+/// \param shard The shard of the calling thread.
+/// \return true if the reader got in.
+auto ReaderWriterMutex::TryEnterShared(ReaderShard& shard) -> bool {
+	shard.readers.fetch_add(1, std::memory_order_seq_cst);
+	if (writer_.load(std::memory_order_seq_cst) == 0) {
+		return true;
+	}
+	LeaveShared(shard);
+	return false;
+}
+
+/// \brief Unregisters a reader and wakes a writer waiting for the shard to drain.
+/// \param shard The shard of the calling thread.
+auto ReaderWriterMutex::LeaveShared(ReaderShard& shard) -> void {
+	if (shard.readers.fetch_sub(1, std::memory_order_seq_cst) == 1 && writer_.load(std::memory_order_seq_cst) != 0) {
+		shard.readers.notify_all();
+	}
+}
+
+/// \brief Waits until no reader is registered in any shard.
+auto ReaderWriterMutex::WaitForReaders() -> void {
+	for (auto& shard : shards_) {
+		Backoff backoff;
+		for (uint32_t readers = shard.readers.load(std::memory_order_seq_cst); readers != 0; readers = shard.readers.load(std::memory_order_seq_cst)) {
+			if (backoff.Exhausted()) {
+				shard.readers.wait(readers, std::memory_order_seq_cst);
+			}
+			else {
+				backoff.Pause();
+			}
+		}
+	}
+}
+}
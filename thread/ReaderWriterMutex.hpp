@@ -0,0 +1,44 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include "CacheLine.hpp"
+
+namespace common::thread
+{
+/// \brief A reader-writer lock for read-mostly data whose readers do not share a counter.
+/// \details The reader count is split into cache-line sized shards and every thread always registers in
+/// the same shard, so concurrent readers on different cores do not bounce a common line between them;
+/// an uncontended lock_shared is one atomic increment on a line the thread usually owns already. Writers
+/// pay for this: they announce themselves with a flag and then wait until every shard has drained. A
+/// waiting writer turns new readers away, so writers do not starve. Waiting threads spin briefly and then
+/// park on std::atomic::wait. It satisfies the SharedLockable requirements and works with std::shared_lock.
+class ReaderWriterMutex
+{
+public:
+	ReaderWriterMutex();
+	auto lock() -> void;
+	auto try_lock() -> bool;
+	auto unlock() -> void;
+	auto lock_shared() -> void;
+	auto try_lock_shared() -> bool;
+	auto unlock_shared() -> void;
+
+private:
+	static constexpr size_t SHARD_COUNT = 64;
+
+	struct alignas(CACHE_LINE_SIZE) ReaderShard
+	{
+		std::atomic<uint32_t> readers{0};
+	};
+
+	static auto ShardIndex() -> size_t;
+	auto TryEnterShared(ReaderShard& shard) -> bool;
+	auto LeaveShared(ReaderShard& shard) -> void;
+	auto WaitForReaders() -> void;
+	alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> writer_;
+	std::array<ReaderShard, SHARD_COUNT> shards_;
+};
+}
@@ -0,0 +1,299 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#include "ScheduledExecutor.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include "DiscardGuard.hpp"
+#include "PooledAllocator.hpp"
+
+namespace common::thread
+{
+ScheduledExecutor::TimerHandle::TimerHandle(std::weak_ptr<Timer> timer) : timer_(std::move(timer)) {}
+
+/// \brief Cancels the task.
+/// \details A run that has already been handed to the pool still executes; no further run starts.
+/// The owner's lock is held throughout, so a concurrent shutdown waits for the cancellation to finish.
+/// \return true if a pending run was cancelled, false if there was none or the executor is shut down.
+auto ScheduledExecutor::TimerHandle::Cancel() -> bool {
+	if (const auto timer = timer_.lock()) {
+		std::lock_guard lock(timer->owner->mutex);
+		if (timer->owner->executor == nullptr) {
+			return false;
+		}
+		return timer->owner->executor->Cancel(*timer);
+	}
+	return false;
+}
+
+/// \brief Returns whether the task is still scheduled or running.
+auto ScheduledExecutor::TimerHandle::IsActive() const -> bool {
+	const auto timer = timer_.lock();
+	return timer && !timer->cancelled;
+}
+
+/// \brief Creates an executor and starts its timer thread.
+/// \param pool The pool running the tasks; it must outlive the executor.
+/// \param tick The resolution of the wheel.
+/// \throws std::invalid_argument if the tick is not positive.
+ScheduledExecutor::ScheduledExecutor(ThreadPool& pool, const std::chrono::milliseconds tick) : pool_(pool), owner_(std::make_shared<Owner>()), tick_(tick), start_(std::chrono::steady_clock::now()), wheels_(), currentTick_(0), wakeTick_(UINT64_MAX), timerCount_(0), stop_(false) {
+	if (tick <= std::chrono::milliseconds::zero()) {
+		throw std::invalid_argument("Tick must be positive");
+	}
+	owner_->executor = this;
+	thread_ = std::thread([this] {
+		TimerLoop();
+	});
+}
+
+ScheduledExecutor::~ScheduledExecutor() {
+	Shutdown();
+}
+
+/// \brief Stops the timer thread and drops every pending timer.
+/// \details Tasks already handed to the pool are not affected. From now on cancelling through a handle
+/// does nothing.
+auto ScheduledExecutor::Shutdown() -> void {
+	{
+		std::lock_guard lock(owner_->mutex);
+		owner_->executor = nullptr;
+	}
+	{
+		std::lock_guard lock(mutex_);
+		if (stop_) return;
+		stop_ = true;
+	}
+	condition_.notify_all();
+	thread_.join();
+	std::lock_guard lock(mutex_);
+	for (auto& wheel : wheels_) {
+		for (Slot& slot : wheel) {
+			while (slot.first) {
+				Timer& timer = *slot.first;
+				timer.cancelled = true;
+				Unlink(timer);
+				timer.self.reset();
+			}
+		}
+	}
+}
+
+/// \brief Returns the number of timers waiting in the wheel.
+auto ScheduledExecutor::GetPendingCount() const -> size_t {
+	std::lock_guard lock(mutex_);
+	return timerCount_;
+}
+
+/// \brief Creates a timer and links it into the wheel.
+/// \param task The task.
+/// \param delay The delay of the first run.
+/// \param period The period, zero for a single run.
+/// \return A handle to the timer.
+auto ScheduledExecutor::Schedule(TaskFunction task, const std::chrono::milliseconds delay, const std::chrono::milliseconds period) -> TimerHandle {
+	auto timer = std::allocate_shared<Timer>(PooledAllocator<Timer>());
+	timer->task = std::move(task);
+	timer->owner = owner_;
+	timer->period = period.count() > 0 ? std::max<uint64_t>(1, TicksOf(period)) : 0;
+	bool wake;
+	{
+		std::lock_guard lock(mutex_);
+		if (stop_) {
+			throw std::runtime_error("Scheduled executor is shut down");
+		}
+		const uint64_t now = NowTick();
+		if (timerCount_ == 0) {
+			// Nothing is linked, so the wheel can jump to the present instead of replaying idle ticks.
+			currentTick_ = std::max(currentTick_, now);
+		}
+		// The current tick has already partly elapsed, so the delay is counted from the start of the next one.
+		timer->expiry = std::max(now + 1 + TicksOf(std::max(delay, std::chrono::milliseconds::zero())), currentTick_ + 1);
+		timer->self = timer;
+		Link(*timer);
+		wake = timer->expiry < wakeTick_;
+	}
+	if (wake) {
+		condition_.notify_one();
+	}
+	return TimerHandle(timer);
+}
+
+/// \brief Unlinks a timer and marks it cancelled.
+/// \return true if the timer was waiting in the wheel.
+auto ScheduledExecutor::Cancel(Timer& timer) -> bool {
+	timer.cancelled = true;
+	std::lock_guard lock(mutex_);
+	if (!timer.self) return false;
+	Unlink(timer);
+	timer.self.reset();
+	return true;
+}
+
+/// \brief Links a timer into the slot of the coarsest level that resolves its expiry.
+/// \details Must be called with mutex_ held.
+auto ScheduledExecutor::Link(Timer& timer) -> void {
+	const uint64_t distance = timer.expiry - currentTick_;
+	size_t level = 0;
+	while (level + 1 < LEVEL_COUNT && distance >> (SLOT_BITS * (level + 1)) != 0) {
+		++level;
+	}
+	uint64_t placement = timer.expiry;
+	if (level + 1 == LEVEL_COUNT && distance >> (SLOT_BITS * LEVEL_COUNT) != 0) {
+		// Beyond the span of the wheel: park in the farthest top-level slot and cascade again later.
+		placement = currentTick_ + (uint64_t{1} << (SLOT_BITS * LEVEL_COUNT)) - 1;
+	}
+	Slot& slot = wheels_[level][(placement >> (SLOT_BITS * level)) & (SLOT_COUNT - 1)];
+	timer.slot = &slot;
+	timer.previous = nullptr;
+	timer.next = slot.first;
+	if (slot.first) {
+		slot.first->previous = &timer;
+	}
+	slot.first = &timer;
+	++timerCount_;
+}
+
+/// \brief Removes a linked timer from its slot.
+/// \details Must be called with mutex_ held.
+auto ScheduledExecutor::Unlink(Timer& timer) -> void {
+	if (timer.previous) {
+		timer.previous->next = timer.next;
+	}
+	else {
+		timer.slot->first = timer.next;
+	}
+	if (timer.next) {
+		timer.next->previous = timer.previous;
+	}
+	timer.slot = nullptr;
+	timer.previous = nullptr;
+	timer.next = nullptr;
+	--timerCount_;
+}
+
+/// \brief Moves the wheel forward by one tick.
+/// \details Must be called with mutex_ held. Whenever a level wraps around, the slot of the next level
+/// that has just come due is emptied and its timers are linked again, which drops them to a finer
+/// level; coarser levels are cascaded first so that their timers can fall through several levels in
+/// one go. The timers of the current slot of the finest level are then due. Periodic timers are
+/// linked again for their next run straight away.
+/// \param due Receives the timers to dispatch.
+auto ScheduledExecutor::Advance(std::vector<std::shared_ptr<Timer>>& due) -> void {
+	++currentTick_;
+	for (size_t level = LEVEL_COUNT - 1; level > 0; --level) {
+		if ((currentTick_ & ((uint64_t{1} << (SLOT_BITS * level)) - 1)) != 0) continue;
+		Slot& slot = wheels_[level][(currentTick_ >> (SLOT_BITS * level)) & (SLOT_COUNT - 1)];
+		Timer* timer = slot.first;
+		slot.first = nullptr;
+		while (timer) {
+			Timer* next = timer->next;
+			--timerCount_;
+			Link(*timer);
+			timer = next;
+		}
+	}
+	Slot& slot = wheels_[0][currentTick_ & (SLOT_COUNT - 1)];
+	Timer* timer = slot.first;
+	slot.first = nullptr;
+	while (timer) {
+		Timer* next = timer->next;
+		--timerCount_;
+		timer->slot = nullptr;
+		timer->previous = nullptr;
+		timer->next = nullptr;
+		if (timer->expiry > currentTick_) {
+			Link(*timer);
+		}
+		else {
+			due.push_back(timer->self);
+			if (timer->period != 0 && !timer->cancelled) {
+				timer->expiry = std::max(timer->expiry + timer->period, currentTick_ + 1);
+				Link(*timer);
+			}
+			else {
+				timer->self.reset();
+			}
+		}
+		timer = next;
+	}
+}
+
+/// \brief Returns the next tick at which the wheel has work: an occupied finest-level slot or a cascade.
+/// \details Must be called with mutex_ held.
+auto ScheduledExecutor::NextWakeTick() const -> uint64_t {
+	if (timerCount_ == 0) return UINT64_MAX;
+	const uint64_t cascade = (currentTick_ | (SLOT_COUNT - 1)) + 1;
+	for (uint64_t tick = currentTick_ + 1; tick < cascade; ++tick) {
+		if (wheels_[0][tick & (SLOT_COUNT - 1)].first) return tick;
+	}
+	return cascade;
+}
+
+/// \brief Hands a due timer's task to the pool.
+/// \details The task is skipped if the previous run of the same timer is still executing or the pool
+/// rejects it. An exception thrown by the task is discarded, as for any task given to Execute, but only
+/// after the run is marked finished, so a periodic timer keeps running after a failed run. A run the
+/// pool rejects or discards without starting it is marked finished just the same.
+auto ScheduledExecutor::Dispatch(const std::shared_ptr<Timer>& timer) -> void {
+	if (timer->running.test_and_set()) return;
+	DiscardGuard guard([timer]() noexcept {
+		timer->running.clear();
+	});
+	pool_.TryExecute([timer, guard = std::move(guard)]() mutable {
+		guard.Dismiss();
+		if (!timer->cancelled || timer->period == 0) {
+			try {
+				timer->task();
+			}
+			catch (...) {
+				// Nobody to report to; the next run of a periodic timer happens as planned.
+			}
+		}
+		timer->running.clear();
+	});
+}
+
+/// \brief The body of the timer thread.
+auto ScheduledExecutor::TimerLoop() -> void {
+	std::vector<std::shared_ptr<Timer>> due;
+	std::unique_lock lock(mutex_);
+	while (!stop_) {
+		if (timerCount_ == 0) {
+			wakeTick_ = UINT64_MAX;
+			condition_.wait(lock, [this] {
+				return stop_ || timerCount_ > 0;
+			});
+			continue;
+		}
+		const uint64_t now = NowTick();
+		while (currentTick_ < now && timerCount_ > 0) {
+			Advance(due);
+		}
+		if (timerCount_ == 0) {
+			currentTick_ = std::max(currentTick_, now);
+		}
+		if (!due.empty()) {
+			lock.unlock();
+			for (const auto& timer : due) {
+				Dispatch(timer);
+			}
+			due.clear();
+			lock.lock();
+			continue;
+		}
+		wakeTick_ = NextWakeTick();
+		if (wakeTick_ != UINT64_MAX) {
+			condition_.wait_until(lock, start_ + tick_ * wakeTick_);
+		}
+	}
+}
+
+/// \brief Converts a duration to whole ticks, rounding up.
+auto ScheduledExecutor::TicksOf(const std::chrono::milliseconds duration) const -> uint64_t {
+	const auto ticks = (std::chrono::duration_cast<std::chrono::steady_clock::duration>(duration) + tick_ - std::chrono::steady_clock::duration(1)) / tick_;
+	return static_cast<uint64_t>(ticks);
+}
+
+/// \brief Returns the number of whole ticks elapsed since the executor was created.
+auto ScheduledExecutor::NowTick() const -> uint64_t {
+	return static_cast<uint64_t>((std::chrono::steady_clock::now() - start_) / tick_);
+}
+}
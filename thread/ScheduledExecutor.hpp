@@ -0,0 +1,149 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "TaskFunction.hpp"
+#include "ThreadPool.hpp"
+
+namespace common::thread
+{
+/// \brief Runs delayed and periodic tasks on a ThreadPool.
+/// \details Timers are kept in a hierarchical timing wheel: LEVEL_COUNT wheels of SLOT_COUNT slots, each
+/// level counting in ticks SLOT_COUNT times coarser than the one below. A timer is linked into the slot of
+/// the coarsest level that still resolves its expiry, and moves down a level whenever the wheel below wraps
+/// around, so scheduling and cancelling are constant time whatever the number of timers. A single timer
+/// thread advances the wheel and hands due tasks to the pool; it sleeps until the next occupied slot or
+/// the next cascade rather than waking every tick. Times are rounded up to whole ticks, so a task never
+/// runs early but may run up to two ticks late. Delays beyond the span of the wheel are supported; such
+/// timers just cascade through the top level more than once.
+class ScheduledExecutor
+{
+	struct Timer;
+
+public:
+	/// \brief A handle to cancel a scheduled task.
+	/// \details Handles may be copied freely. Cancelling through a handle whose executor has been shut
+	/// down or destroyed does nothing, even while a run of the task is still queued in the pool, and may
+	/// race with the shutdown.
+	class TimerHandle
+	{
+	public:
+		TimerHandle() = default;
+		auto Cancel() -> bool;
+		[[nodiscard]] auto IsActive() const -> bool;
+
+	private:
+		friend class ScheduledExecutor;
+		explicit TimerHandle(std::weak_ptr<Timer> timer);
+		std::weak_ptr<Timer> timer_;
+	};
+
+	explicit ScheduledExecutor(ThreadPool& pool, std::chrono::milliseconds tick = DEFAULT_TICK);
+	ScheduledExecutor(const ScheduledExecutor&) = delete;
+	auto operator=(const ScheduledExecutor&) -> ScheduledExecutor& = delete;
+	~ScheduledExecutor();
+	template <class F> auto ScheduleAfter(std::chrono::milliseconds delay, F&& f) -> TimerHandle;
+	template <class F> auto ScheduleAtFixedRate(std::chrono::milliseconds initialDelay, std::chrono::milliseconds period, F&& f) -> TimerHandle;
+	auto Shutdown() -> void;
+	[[nodiscard]] auto GetPendingCount() const -> size_t;
+
+private:
+	static constexpr std::chrono::milliseconds DEFAULT_TICK{1};
+	static constexpr size_t SLOT_BITS = 8;
+	static constexpr size_t SLOT_COUNT = size_t{1} << SLOT_BITS;
+	static constexpr size_t LEVEL_COUNT = 4;
+
+	struct Slot;
+
+	/// \brief The executor as seen by its timers.
+	/// \details Shared by the executor and every timer, and cleared on shutdown, so that a handle whose
+	/// timer is kept alive by a run still queued in the pool never reaches a destroyed executor.
+	struct Owner
+	{
+		std::mutex mutex;
+		ScheduledExecutor* executor{nullptr};
+	};
+
+	/// \brief A scheduled task, owned by the wheel through self while it is linked.
+	struct Timer
+	{
+		TaskFunction task;
+		std::shared_ptr<Owner> owner;
+		uint64_t expiry{0};
+		uint64_t period{0};
+		Slot* slot{nullptr};
+		Timer* previous{nullptr};
+		Timer* next{nullptr};
+		std::shared_ptr<Timer> self;
+		std::atomic<bool> cancelled{false};
+		std::atomic_flag running;
+	};
+
+	/// \brief The head of the intrusive list of timers in one slot.
+	struct Slot
+	{
+		Timer* first{nullptr};
+	};
+
+	auto Schedule(TaskFunction task, std::chrono::milliseconds delay, std::chrono::milliseconds period) -> TimerHandle;
+	auto Cancel(Timer& timer) -> bool;
+	auto Link(Timer& timer) -> void;
+	auto Unlink(Timer& timer) -> void;
+	auto Advance(std::vector<std::shared_ptr<Timer>>& due) -> void;
+	auto NextWakeTick() const -> uint64_t;
+	auto Dispatch(const std::shared_ptr<Timer>& timer) -> void;
+	auto TimerLoop() -> void;
+	auto TicksOf(std::chrono::milliseconds duration) const -> uint64_t;
+	auto NowTick() const -> uint64_t;
+	ThreadPool& pool_;
+	std::shared_ptr<Owner> owner_;
+	std::chrono::steady_clock::duration tick_;
+	std::chrono::steady_clock::time_point start_;
+	std::array<std::array<Slot, SLOT_COUNT>, LEVEL_COUNT> wheels_;
+	uint64_t currentTick_;
+	uint64_t wakeTick_;
+	size_t timerCount_;
+	bool stop_;
+	mutable std::mutex mutex_;
+	std::condition_variable condition_;
+	std::thread thread_;
+};
+
+/// \brief Runs a task once after a delay.
+/// \tparam F The type of the task, callable without arguments.
+/// \param delay The minimum time before the task is handed to the pool.
+/// \param f The task.
+/// \return A handle to cancel the task.
+/// \throws std::runtime_error if the executor has been shut down.
+template <class F> auto ScheduledExecutor::ScheduleAfter(const std::chrono::milliseconds delay, F&& f) -> TimerHandle {
+	return Schedule(TaskFunction(std::forward<F>(f)), delay, std::chrono::milliseconds::zero());
+}
+
+/// \brief Runs a task periodically.
+/// \details Runs are planned at initialDelay + n * period from now, independently of how long each run
+/// takes. A run that is due while the previous one is still executing is skipped, so runs of the same
+/// task never overlap, and runs missed while the pool was saturated are not made up for. A run that throws
+/// does not end the schedule; the exception is discarded and the next run happens as planned.
+/// \tparam F The type of the task, callable without arguments.
+/// \param initialDelay The minimum time before the first run.
+/// \param period The time between the starts of two runs.
+/// \param f The task.
+/// \return A handle to cancel the remaining runs.
+/// \throws std::invalid_argument if the period is not positive.
+/// \throws std::runtime_error if the executor has been shut down.
+template <class F> auto ScheduledExecutor::ScheduleAtFixedRate(const std::chrono::milliseconds initialDelay, const std::chrono::milliseconds period, F&& f) -> TimerHandle {
+	if (period <= std::chrono::milliseconds::zero()) {
+		throw std::invalid_argument("Period must be positive");
+	}
+	return Schedule(TaskFunction(std::forward<F>(f)), initialDelay, period);
+}
+}
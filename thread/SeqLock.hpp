@@ -0,0 +1,95 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#pragma once
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "Backoff.hpp"
+#include "CacheLine.hpp"
+
+namespace common::thread
+{
+/// \brief A sequence lock publishing small snapshots of plain data.
+/// \details Readers never write shared memory: they read the sequence number, copy the value and read
+/// the sequence number again, retrying if a writer was active in between. Reads therefore scale with the
+/// number of cores and never block writers, at the cost of a retry when they race with a store. Writers
+/// are serialized with each other by making the sequence number odd while they copy the value in. The
+/// value is kept in relaxed atomic words so that the racing copies are well defined.
+/// \tparam T The type of the value, trivially copyable and preferably a few cache lines at most. It
+/// needs to be default constructible only for the default constructor.
+template <typename T> class SeqLock
+{
+	static_assert(std::is_trivially_copyable_v<T>, "SeqLock requires a trivially copyable type");
+
+public:
+	SeqLock();
+	explicit SeqLock(const T& value);
+	[[nodiscard]] auto Load() const -> T;
+	auto Store(const T& value) -> void;
+
+private:
+	static constexpr size_t WORD_COUNT = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+	using Words = std::array<uint64_t, WORD_COUNT>;
+	alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> sequence_;
+	std::array<std::atomic<uint64_t>, WORD_COUNT> words_;
+};
+
+/// \brief Creates a sequence lock holding a value-initialized T.
+template <typename T> SeqLock<T>::SeqLock() : SeqLock(T{}) {}
+
+/// \brief Creates a sequence lock holding a value.
+/// \param value The initial value.
+template <typename T> SeqLock<T>::SeqLock(const T& value) : sequence_(0) {
+	Words words{};
+	std::memcpy(words.data(), &value, sizeof(T));
+	for (size_t i = 0; i < WORD_COUNT; ++i) {
+		words_[i].store(words[i], std::memory_order_relaxed);
+	}
+}
+
+/// \brief Returns a consistent copy of the value.
+/// \details Spins while a store is in progress. The copy is built with std::bit_cast, so T need not be
+/// default constructible.
+template <typename T> auto SeqLock<T>::Load() const -> T {
+	Words words;
+	while (true) {
+		const uint64_t before = sequence_.load(std::memory_order_acquire);
+		if ((before & 1) == 0) {
+			for (size_t i = 0; i < WORD_COUNT; ++i) {
+				words[i] = words_[i].load(std::memory_order_relaxed);
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (sequence_.load(std::memory_order_relaxed) == before) {
+				break;
+			}
+		}
+		CpuRelax();
+	}
+	std::array<std::byte, sizeof(T)> bytes;
+	std::memcpy(bytes.data(), words.data(), sizeof(T));
+	return std::bit_cast<T>(bytes);
+}
+
+/// \brief Replaces the value.
+/// \param value The new value.
+template <typename T> auto SeqLock<T>::Store(const T& value) -> void {
+	Words words{};
+	std::memcpy(words.data(), &value, sizeof(T));
+	Backoff backoff;
+	uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+	while ((sequence & 1) != 0 || !sequence_.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+		backoff.Pause();
+		sequence = sequence_.load(std::memory_order_relaxed);
+	}
+	// Keeps the word stores below from becoming visible before the odd sequence number.
+	std::atomic_thread_fence(std::memory_order_release);
+	for (size_t i = 0; i < WORD_COUNT; ++i) {
+		words_[i].store(words[i], std::memory_order_relaxed);
+	}
+	sequence_.store(sequence + 2, std::memory_order_release);
+}
+}
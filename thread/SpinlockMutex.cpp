@@ -1,26 +1,53 @@
 // Created by author ethereal on 2024/11/20.
 // Copyright (c) 2024 ethereal. All rights reserved.
 #include "SpinlockMutex.hpp"
-#include <thread>
+#include "Backoff.hpp"
 
 namespace common::thread
 {
-SpinlockMutex::SpinlockMutex() = default;
+SpinlockMutex::SpinlockMutex() : state_(UNLOCKED) {}
 
 /// \brief Acquires the spinlock, blocking if necessary until it becomes
 /// available.
-/// \details Continuously attempts to set the atomic flag. If the flag is
-/// already set, the thread yields to allow other thread to proceed.
+/// \details Spins on a plain load with exponential backoff while the lock is
+/// held and only attempts the exchange once it looks free. After the spin
+/// budget the lock is marked as having waiters and the thread parks until
+/// unlock wakes it.
 auto SpinlockMutex::lock() -> void {
-	while (flag_.test_and_set(std::memory_order_acquire)) {
-		std::this_thread::yield();
+	uint32_t expected = UNLOCKED;
+	if (state_.compare_exchange_strong(expected, LOCKED, std::memory_order_acquire, std::memory_order_relaxed)) {
+		return;
+	}
+	Backoff backoff;
+	while (!backoff.Exhausted()) {
+		if (state_.load(std::memory_order_relaxed) == UNLOCKED) {
+			expected = UNLOCKED;
+			if (state_.compare_exchange_weak(expected, LOCKED, std::memory_order_acquire, std::memory_order_relaxed)) {
+				return;
+			}
+		}
+		backoff.Pause();
+	}
+	// A parked thread may own the lock after waking, so it keeps LOCKED_WITH_WAITERS to make sure the
+	// next unlock still wakes whoever else is parked.
+	while (state_.exchange(LOCKED_WITH_WAITERS, std::memory_order_acquire) != UNLOCKED) {
+		state_.wait(LOCKED_WITH_WAITERS, std::memory_order_relaxed);
 	}
 }
 
+/// \brief Tries to acquire the spinlock without blocking.
+/// \return true if the lock was acquired, false if it is held by another thread.
+auto SpinlockMutex::try_lock() -> bool {
+	uint32_t expected = UNLOCKED;
+	return state_.load(std::memory_order_relaxed) == UNLOCKED && state_.compare_exchange_strong(expected, LOCKED, std::memory_order_acquire, std::memory_order_relaxed);
+}
+
 /// \brief Releases the spinlock.
-/// \details If there are thread waiting for the spinlock to become available,
-/// one of them will be unblocked.
+/// \details If there are thread parked waiting for the spinlock to become
+/// available, one of them will be unblocked.
 auto SpinlockMutex::unlock() -> void {
-	flag_.clear(std::memory_order_release);
+	if (state_.exchange(UNLOCKED, std::memory_order_release) == LOCKED_WITH_WAITERS) {
+		state_.notify_one();
+	}
 }
 }
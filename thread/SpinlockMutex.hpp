@@ -2,22 +2,28 @@
 // Copyright (c) 2024 ethereal. All rights reserved.
 #pragma once
 #include <atomic>
+#include <cstdint>
 
 namespace common::thread
 {
-/// \brief A simple spinlock mutex.
-/// \details This class is a simple, lock-free spinlock mutex.
-/// It is designed to be used in situations where a critical section of code is very short, such as when accessing a
-/// shared resource. Because it is based on a spinlock, it will burn CPU cycles if it can't acquire the lock
-/// immediately.
+/// \brief An adaptive spin-then-park mutex.
+/// \details This class is a small mutex meant for critical sections that are very short, such as when accessing
+/// a shared resource. A contended lock first spins test-and-test-and-set style: it only reads the lock word,
+/// which stays in the local cache, and backs off exponentially with pause instructions between attempts. If
+/// the lock is still held once the spin budget is used up, the thread parks on std::atomic::wait and is woken
+/// by unlock, so a long wait does not burn a core. It satisfies the Lockable requirements.
 class SpinlockMutex
 {
 public:
 	SpinlockMutex();
 	auto lock() -> void;
+	auto try_lock() -> bool;
 	auto unlock() -> void;
 
 private:
-	std::atomic_flag flag_;
+	static constexpr uint32_t UNLOCKED = 0;
+	static constexpr uint32_t LOCKED = 1;
+	static constexpr uint32_t LOCKED_WITH_WAITERS = 2;
+	std::atomic<uint32_t> state_;
 };
 }
@@ -0,0 +1,181 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#pragma once
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include "PooledAllocator.hpp"
+
+namespace common::thread
+{
+template <typename T> class Task;
+
+/// \brief The state shared by the promises of every Task.
+/// \details A task remembers the coroutine awaiting it and transfers control straight to it when it
+/// finishes, so a chain of awaits neither blocks a thread nor grows the stack. Coroutine frames are
+/// allocated from the calling thread's BlockCache.
+class TaskPromiseBase
+{
+public:
+	/// \brief Resumes the awaiting coroutine once the task has finished.
+	struct FinalAwaiter
+	{
+		[[nodiscard]] auto await_ready() const noexcept -> bool {
+			return false;
+		}
+
+		template <typename Promise> auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> std::coroutine_handle<> {
+			return handle.promise().continuation_;
+		}
+
+		auto await_resume() noexcept -> void {}
+	};
+
+	auto initial_suspend() noexcept -> std::suspend_always {
+		return {};
+	}
+
+	auto final_suspend() noexcept -> FinalAwaiter {
+		return {};
+	}
+
+	auto unhandled_exception() noexcept -> void {
+		error_ = std::current_exception();
+	}
+
+	auto SetContinuation(const std::coroutine_handle<> continuation) noexcept -> void {
+		continuation_ = continuation;
+	}
+
+	static auto operator new(const size_t size) -> void* {
+		return BlockCache::Allocate(size);
+	}
+
+	static auto operator delete(void* frame, const size_t size) -> void {
+		BlockCache::Deallocate(frame, size);
+	}
+
+protected:
+	auto RethrowIfFailed() const -> void {
+		if (error_) {
+			std::rethrow_exception(error_);
+		}
+	}
+
+private:
+	std::coroutine_handle<> continuation_{std::noop_coroutine()};
+	std::exception_ptr error_;
+};
+
+/// \brief The promise of a Task producing a value.
+template <typename T> class TaskPromise final : public TaskPromiseBase
+{
+public:
+	auto get_return_object() noexcept -> Task<T>;
+
+	template <typename U> auto return_value(U&& value) -> void {
+		value_.emplace(std::forward<U>(value));
+	}
+
+	auto Result() -> T {
+		RethrowIfFailed();
+		return std::move(*value_);
+	}
+
+private:
+	std::optional<T> value_;
+};
+
+/// \brief The promise of a Task producing no value.
+template <> class TaskPromise<void> final : public TaskPromiseBase
+{
+public:
+	auto get_return_object() noexcept -> Task<void>;
+
+	auto return_void() noexcept -> void {}
+
+	auto Result() -> void {
+		RethrowIfFailed();
+	}
+};
+
+/// \brief A lazily started coroutine producing a value of type T.
+/// \details A task does not run until it is awaited. The awaiting coroutine is suspended and resumed
+/// on whichever thread finishes the task, so a pipeline of tasks that hop onto a ThreadPool with
+/// co_await pool.Schedule() keeps no thread blocked while it waits. An exception escaping the
+/// coroutine is rethrown to the awaiter. Use TaskUtil to combine tasks or to wait for one from
+/// ordinary code.
+/// \tparam T The type of the result, void for none.
+template <typename T = void> class [[nodiscard]] Task final
+{
+public:
+	using promise_type = TaskPromise<T>;
+	Task(Task&& other) noexcept;
+	auto operator=(Task&& other) noexcept -> Task&;
+	Task(const Task&) = delete;
+	auto operator=(const Task&) -> Task& = delete;
+	~Task();
+	auto operator co_await() && noexcept;
+
+private:
+	friend class TaskPromise<T>;
+	explicit Task(std::coroutine_handle<promise_type> handle) noexcept;
+	std::coroutine_handle<promise_type> handle_;
+};
+
+template <typename T> auto TaskPromise<T>::get_return_object() noexcept -> Task<T> {
+	return Task<T>(std::coroutine_handle<TaskPromise>::from_promise(*this));
+}
+
+inline auto TaskPromise<void>::get_return_object() noexcept -> Task<void> {
+	return Task<void>(std::coroutine_handle<TaskPromise>::from_promise(*this));
+}
+
+template <typename T> Task<T>::Task(const std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+template <typename T> Task<T>::Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+
+template <typename T> auto Task<T>::operator=(Task&& other) noexcept -> Task& {
+	if (this != &other) {
+		if (handle_) {
+			handle_.destroy();
+		}
+		handle_ = std::exchange(other.handle_, nullptr);
+	}
+	return *this;
+}
+
+/// \brief Destroys the coroutine frame.
+/// \details A task must not be destroyed while it is running; awaiting it guarantees this.
+template <typename T> Task<T>::~Task() {
+	if (handle_) {
+		handle_.destroy();
+	}
+}
+
+/// \brief Starts the task and suspends the awaiting coroutine until the task has finished.
+/// \return An awaiter producing the result of the task, or rethrowing its exception.
+template <typename T> auto Task<T>::operator co_await() && noexcept {
+	struct Awaiter
+	{
+		std::coroutine_handle<promise_type> handle;
+
+		[[nodiscard]] auto await_ready() const noexcept -> bool {
+			return false;
+		}
+
+		auto await_suspend(const std::coroutine_handle<> awaiting) noexcept -> std::coroutine_handle<> {
+			handle.promise().SetContinuation(awaiting);
+			return handle;
+		}
+
+		auto await_resume() -> T {
+			return handle.promise().Result();
+		}
+	};
+
+	return Awaiter{handle_};
+}
+}
@@ -0,0 +1,122 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace common::thread
+{
+/// \brief A move-only `void()` callable with small buffer storage.
+/// \details Unlike std::function the callable does not have to be copyable, so it can own a std::promise
+/// or a std::unique_ptr. Callables of up to INLINE_CAPACITY bytes that are nothrow move constructible are
+/// stored inside the object itself; only larger ones are placed on the heap.
+class TaskFunction final
+{
+public:
+	static constexpr size_t INLINE_CAPACITY = 64;
+	TaskFunction() noexcept = default;
+	template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, TaskFunction>>> TaskFunction(F&& func);
+	TaskFunction(TaskFunction&& other) noexcept;
+	auto operator=(TaskFunction&& other) noexcept -> TaskFunction&;
+	TaskFunction(const TaskFunction&) = delete;
+	auto operator=(const TaskFunction&) -> TaskFunction& = delete;
+	~TaskFunction();
+	auto operator()() -> void;
+	explicit operator bool() const noexcept;
+
+private:
+	struct Operations
+	{
+		void (*invoke)(void* storage);
+		void (*move)(void* from, void* to) noexcept;
+		void (*destroy)(void* storage) noexcept;
+	};
+
+	template <typename F> static constexpr bool STORED_INLINE = sizeof(F) <= INLINE_CAPACITY && alignof(F) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<F>;
+	template <typename F> static const Operations INLINE_OPERATIONS;
+	template <typename F> static const Operations HEAP_OPERATIONS;
+	alignas(std::max_align_t) std::byte storage_[INLINE_CAPACITY]{};
+	const Operations* operations_{nullptr};
+};
+
+template <typename F> const TaskFunction::Operations TaskFunction::INLINE_OPERATIONS = {
+	[](void* storage) {
+		(*static_cast<F*>(storage))();
+	},
+	[](void* from, void* to) noexcept {
+		::new(to) F(std::move(*static_cast<F*>(from)));
+		static_cast<F*>(from)->~F();
+	},
+	[](void* storage) noexcept {
+		static_cast<F*>(storage)->~F();
+	}
+};
+
+template <typename F> const TaskFunction::Operations TaskFunction::HEAP_OPERATIONS = {
+	[](void* storage) {
+		(**static_cast<F**>(storage))();
+	},
+	[](void* from, void* to) noexcept {
+		::new(to) F*(*static_cast<F**>(from));
+	},
+	[](void* storage) noexcept {
+		delete *static_cast<F**>(storage);
+	}
+};
+
+/// \brief Wraps a callable.
+/// \param func The callable, invoked without arguments.
+template <typename F, typename> TaskFunction::TaskFunction(F&& func) {
+	using Callable = std::decay_t<F>;
+	if constexpr (STORED_INLINE<Callable>) {
+		::new(static_cast<void*>(storage_)) Callable(std::forward<F>(func));
+		operations_ = &INLINE_OPERATIONS<Callable>;
+	}
+	else {
+		::new(static_cast<void*>(storage_)) Callable*(new Callable(std::forward<F>(func)));
+		operations_ = &HEAP_OPERATIONS<Callable>;
+	}
+}
+
+/// \brief Takes over the callable of \p other, leaving it empty.
+inline TaskFunction::TaskFunction(TaskFunction&& other) noexcept : operations_(other.operations_) {
+	if (operations_) {
+		operations_->move(other.storage_, storage_);
+		other.operations_ = nullptr;
+	}
+}
+
+/// \brief Destroys the current callable and takes over the callable of \p other.
+inline auto TaskFunction::operator=(TaskFunction&& other) noexcept -> TaskFunction& {
+	if (this != &other) {
+		if (operations_) {
+			operations_->destroy(storage_);
+		}
+		operations_ = other.operations_;
+		if (operations_) {
+			operations_->move(other.storage_, storage_);
+			other.operations_ = nullptr;
+		}
+	}
+	return *this;
+}
+
+inline TaskFunction::~TaskFunction() {
+	if (operations_) {
+		operations_->destroy(storage_);
+	}
+}
+
+/// \brief Invokes the callable.
+/// \details Must not be called on an empty TaskFunction.
+inline auto TaskFunction::operator()() -> void {
+	operations_->invoke(storage_);
+}
+
+/// \brief Tests whether a callable is stored.
+inline TaskFunction::operator bool() const noexcept {
+	return operations_ != nullptr;
+}
+}
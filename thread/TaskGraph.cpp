@@ -0,0 +1,202 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#include "TaskGraph.hpp"
+#include "DiscardGuard.hpp"
+
+namespace common::thread
+{
+TaskNodeBase::TaskNodeBase(const TaskGraph* graph, const size_t index) : graph_(graph), index_(index) {}
+
+/// \brief Returns the position of the node in its graph, in order of creation.
+auto TaskNodeBase::GetIndex() const -> size_t {
+	return index_;
+}
+
+TaskGraph::TaskGraph() : running_(false), failed_(false), remaining_(0), pool_(nullptr) {}
+
+/// \brief Makes a node wait for another one without passing its result.
+/// \param node The node that has to wait.
+/// \param dependency The node that has to finish first.
+/// \throws std::invalid_argument if a node belongs to another graph or the edge would create a cycle.
+/// \throws std::runtime_error if the graph is running.
+auto TaskGraph::AddDependency(const TaskNodeBase& node, const TaskNodeBase& dependency) -> void {
+	CheckNotRunning();
+	CheckOwnership(node);
+	CheckOwnership(dependency);
+	if (Reaches(node.index_, dependency.index_)) {
+		throw std::invalid_argument("Dependency would create a cycle in the task graph");
+	}
+	Link(dependency.index_, node.index_);
+}
+
+/// \brief Starts a run of the graph.
+/// \details Every node runs once. The results of the previous run are cleared first.
+/// \param pool The pool executing the nodes.
+/// \return A future that becomes ready once the run has finished and holds the first exception a node threw.
+/// \throws std::runtime_error if the graph is already running.
+auto TaskGraph::Run(ThreadPool& pool) -> std::future<void> {
+	if (running_.exchange(true)) {
+		throw std::runtime_error("Task graph is already running");
+	}
+	pool_ = &pool;
+	failed_ = false;
+	error_ = nullptr;
+	promise_ = std::promise<void>();
+	auto future = promise_.get_future();
+	std::vector<size_t> roots;
+	for (size_t i = 0; i < nodes_.size(); ++i) {
+		nodes_[i]->reset();
+		nodes_[i]->pending.store(nodes_[i]->dependencyCount, std::memory_order_relaxed);
+		if (nodes_[i]->dependencyCount == 0) {
+			roots.push_back(i);
+		}
+	}
+	remaining_.store(nodes_.size());
+	if (nodes_.empty()) {
+		Finish();
+		return future;
+	}
+	for (const size_t root : roots) {
+		Dispatch(root);
+	}
+	return future;
+}
+
+/// \brief Returns the number of nodes in the graph.
+auto TaskGraph::GetNodeCount() const -> size_t {
+	return nodes_.size();
+}
+
+/// \brief Appends a node without dependencies.
+/// \return The index of the node.
+auto TaskGraph::AddNode(TaskFunction work, std::function<void()> reset) -> size_t {
+	auto node = std::make_unique<Node>();
+	node->work = std::move(work);
+	node->reset = std::move(reset);
+	nodes_.push_back(std::move(node));
+	return nodes_.size() - 1;
+}
+
+/// \brief Adds an edge from a node to one of its successors.
+auto TaskGraph::Link(const size_t from, const size_t to) -> void {
+	nodes_[from]->successors.push_back(to);
+	++nodes_[to]->dependencyCount;
+}
+
+/// \throws std::invalid_argument if the node was created by another graph.
+auto TaskGraph::CheckOwnership(const TaskNodeBase& node) const -> void {
+	if (node.graph_ != this) {
+		throw std::invalid_argument("Task node belongs to another graph");
+	}
+}
+
+/// \throws std::runtime_error if the graph is running.
+auto TaskGraph::CheckNotRunning() const -> void {
+	if (running_) {
+		throw std::runtime_error("Task graph cannot be modified while it is running");
+	}
+}
+
+/// \brief Returns whether a node can be reached from another one by following edges.
+auto TaskGraph::Reaches(const size_t from, const size_t to) const -> bool {
+	std::vector<bool> visited(nodes_.size());
+	std::vector<size_t> stack{from};
+	while (!stack.empty()) {
+		const size_t current = stack.back();
+		stack.pop_back();
+		if (current == to) return true;
+		if (visited[current]) continue;
+		visited[current] = true;
+		for (const size_t successor : nodes_[current]->successors) {
+			stack.push_back(successor);
+		}
+	}
+	return false;
+}
+
+/// \brief Hands a ready node to the pool, or runs it on the calling thread if the pool is full.
+/// \details Once the run has failed no work is left to do, so the node is only released, on the calling
+/// thread. A node the pool discards later without running it abandons the run. The dispatching flag tells
+/// a discard during the call, which is handled here, from one after it.
+auto TaskGraph::Dispatch(const size_t index) -> void {
+	Node& node = *nodes_[index];
+	if (failed_) {
+		RunNode(index);
+		return;
+	}
+	node.dispatching = true;
+	DiscardGuard guard([this, index]() noexcept {
+		if (!nodes_[index]->dispatching.exchange(false)) {
+			Abandon(index);
+		}
+	});
+	pool_->TryExecute([this, index, guard = std::move(guard)]() mutable {
+		guard.Dismiss();
+		RunNode(index);
+	});
+	if (!node.dispatching.exchange(false)) {
+		RunNode(index);
+	}
+}
+
+/// \brief Fails the run because the pool discarded a node without running it.
+/// \details The error is a broken promise, as for a discarded Submit task. The node is then released like
+/// any other, which skips its work and that of every node after it, so the run still completes.
+/// \param index The discarded node.
+auto TaskGraph::Abandon(const size_t index) -> void {
+	if (!failed_.exchange(true)) {
+		error_ = std::make_exception_ptr(std::future_error(std::future_errc::broken_promise));
+	}
+	RunNode(index);
+}
+
+/// \brief Runs a node and releases its successors.
+/// \details The first successor that becomes ready is run in the same call instead of being queued.
+/// \param index The node to run.
+auto TaskGraph::RunNode(size_t index) -> void {
+	while (true) {
+		Node& node = *nodes_[index];
+		if (!failed_) {
+			try {
+				node.work();
+			}
+			catch (...) {
+				if (!failed_.exchange(true)) {
+					error_ = std::current_exception();
+				}
+			}
+		}
+		std::optional<size_t> next;
+		for (const size_t successor : node.successors) {
+			if (nodes_[successor]->pending.fetch_sub(1) == 1) {
+				if (next) {
+					Dispatch(successor);
+				}
+				else {
+					next = successor;
+				}
+			}
+		}
+		if (remaining_.fetch_sub(1) == 1) {
+			Finish();
+			return;
+		}
+		if (!next) return;
+		index = *next;
+	}
+}
+
+/// \brief Completes the current run.
+/// \details The graph may be destroyed as soon as the promise is fulfilled, so no member is touched afterwards.
+auto TaskGraph::Finish() -> void {
+	auto promise = std::move(promise_);
+	const auto error = error_;
+	running_ = false;
+	if (error) {
+		promise.set_exception(error);
+	}
+	else {
+		promise.set_value();
+	}
+}
+}
@@ -0,0 +1,154 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#pragma once
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "TaskFunction.hpp"
+#include "ThreadPool.hpp"
+
+namespace common::thread
+{
+class TaskGraph;
+
+/// \brief A handle to a node of a TaskGraph, used to declare dependencies.
+class TaskNodeBase
+{
+public:
+	[[nodiscard]] auto GetIndex() const -> size_t;
+
+protected:
+	TaskNodeBase(const TaskGraph* graph, size_t index);
+
+private:
+	friend class TaskGraph;
+	const TaskGraph* graph_;
+	size_t index_;
+};
+
+/// \brief A handle to a node of a TaskGraph producing a value of type R.
+/// \details Passing the handle to TaskGraph::Emplace feeds the value into the new node. After a run has
+/// completed the value can be read with Result; it stays valid until the next run starts.
+/// \tparam R The type of the value, void for none.
+template <typename R> class TaskNode final : public TaskNodeBase
+{
+public:
+	/// \brief The type the value is stored as; void nodes only record that they ran.
+	using Value = std::conditional_t<std::is_void_v<R>, bool, R>;
+	[[nodiscard]] auto Result() const -> const Value& requires(!std::is_void_v<R>);
+
+private:
+	friend class TaskGraph;
+
+	/// \brief The storage for the value of a node.
+	struct Storage
+	{
+		std::optional<Value> value;
+	};
+
+	TaskNode(const TaskGraph* graph, size_t index, std::shared_ptr<Storage> storage);
+	std::shared_ptr<Storage> storage_;
+};
+
+/// \brief A directed acyclic graph of tasks executed on a ThreadPool.
+/// \details Nodes are callables whose arguments are the results of the nodes they depend on, so data
+/// flows along the edges; AddDependency adds edges that only order nodes. A node is dispatched to the
+/// pool as soon as its last dependency has finished, so independent branches run concurrently and
+/// fan-in nodes start without a thread waiting for their inputs. A worker finishing a node runs one
+/// newly ready successor itself and submits the others, which keeps chains on the same core. The
+/// graph is built once and can then be run any number of times, one run at a time; it must outlive
+/// its runs. The first exception thrown by a node stops dispatching new work and is reported through
+/// the future returned by Run. A node the pool discards without running it, under the DiscardOldest
+/// rejection policy or in ShutdownNow, fails the run the same way with a broken promise.
+class TaskGraph
+{
+public:
+	TaskGraph();
+	TaskGraph(const TaskGraph&) = delete;
+	auto operator=(const TaskGraph&) -> TaskGraph& = delete;
+	template <class F, class... R> auto Emplace(F&& func, const TaskNode<R>&... dependencies) -> TaskNode<std::invoke_result_t<std::decay_t<F>&, const R&...>>;
+	auto AddDependency(const TaskNodeBase& node, const TaskNodeBase& dependency) -> void;
+	auto Run(ThreadPool& pool) -> std::future<void>;
+	[[nodiscard]] auto GetNodeCount() const -> size_t;
+
+private:
+	struct Node
+	{
+		TaskFunction work;
+		std::function<void()> reset;
+		std::vector<size_t> successors;
+		size_t dependencyCount{0};
+		std::atomic<size_t> pending{0};
+		std::atomic<bool> dispatching{false};
+	};
+
+	auto AddNode(TaskFunction work, std::function<void()> reset) -> size_t;
+	auto Link(size_t from, size_t to) -> void;
+	auto CheckOwnership(const TaskNodeBase& node) const -> void;
+	auto CheckNotRunning() const -> void;
+	auto Reaches(size_t from, size_t to) const -> bool;
+	auto Dispatch(size_t index) -> void;
+	auto Abandon(size_t index) -> void;
+	auto RunNode(size_t index) -> void;
+	auto Finish() -> void;
+	std::vector<std::unique_ptr<Node>> nodes_;
+	std::atomic<bool> running_;
+	std::atomic<bool> failed_;
+	std::atomic<size_t> remaining_;
+	std::exception_ptr error_;
+	std::promise<void> promise_;
+	ThreadPool* pool_;
+};
+
+template <typename R> TaskNode<R>::TaskNode(const TaskGraph* graph, const size_t index, std::shared_ptr<Storage> storage) : TaskNodeBase(graph, index), storage_(std::move(storage)) {}
+
+/// \brief Returns the value the node produced in the last run.
+/// \throws std::runtime_error if the node has not produced a value, because the graph has not run yet
+/// or the last run failed before reaching it.
+template <typename R> auto TaskNode<R>::Result() const -> const Value& requires(!std::is_void_v<R>) {
+	if (!storage_->value) {
+		throw std::runtime_error("Task node has no result");
+	}
+	return *storage_->value;
+}
+
+/// \brief Adds a node to the graph.
+/// \tparam F The type of the callable.
+/// \tparam R The result types of the dependencies.
+/// \param func The callable, invoked with the results of \p dependencies in order. It is kept by the
+/// graph and invoked once per run.
+/// \param dependencies The nodes whose results the callable takes; none of them may produce void.
+/// \return The handle of the new node.
+/// \throws std::invalid_argument if a dependency belongs to another graph.
+/// \throws std::runtime_error if the graph is running.
+template <class F, class... R> auto TaskGraph::Emplace(F&& func, const TaskNode<R>&... dependencies) -> TaskNode<std::invoke_result_t<std::decay_t<F>&, const R&...>> {
+	static_assert((!std::is_void_v<R> && ...), "Only nodes producing a value can be passed as arguments; use AddDependency to order after a void node");
+	using Result = std::invoke_result_t<std::decay_t<F>&, const R&...>;
+	CheckNotRunning();
+	(CheckOwnership(dependencies), ...);
+	auto storage = std::make_shared<typename TaskNode<Result>::Storage>();
+	TaskFunction work([func = std::forward<F>(func), storage, inputs = std::make_tuple(dependencies.storage_...)]() mutable {
+		std::apply([&](const auto&... input) {
+			if constexpr (std::is_void_v<Result>) {
+				std::invoke(func, *input->value...);
+				storage->value.emplace(true);
+			}
+			else {
+				storage->value.emplace(std::invoke(func, *input->value...));
+			}
+		}, inputs);
+	});
+	const size_t index = AddNode(std::move(work), [storage] {
+		storage->value.reset();
+	});
+	(Link(dependencies.index_, index), ...);
+	return TaskNode<Result>(this, index, std::move(storage));
+}
+}
@@ -0,0 +1,269 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+#include "Task.hpp"
+
+namespace common::thread
+{
+/// \brief Combinators for Task coroutines.
+/// \details WhenAll and WhenAny start every task on the calling thread and let each one run until it first
+/// suspends, typically on co_await pool.Schedule(), so tasks that hop onto a ThreadPool run concurrently.
+/// The awaiting coroutine is resumed by whichever thread completes the combination. SyncWait bridges from
+/// ordinary code into coroutines by blocking the calling thread until a task has finished; it must not be
+/// called from a pool worker that the task needs.
+class TaskUtil abstract
+{
+	/// \brief The type a result of T is stored as, std::monostate for void.
+	template <typename T> using Stored = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+public:
+	template <typename T> static auto WhenAll(std::vector<Task<T>> tasks) -> Task<std::conditional_t<std::is_void_v<T>, void, std::vector<T>>>;
+	template <typename T> static auto WhenAny(std::vector<Task<T>> tasks) -> Task<std::conditional_t<std::is_void_v<T>, size_t, std::pair<size_t, T>>>;
+	template <typename T> static auto SyncWait(Task<T> task) -> T;
+
+private:
+	/// \brief A coroutine that runs as soon as it is resumed and frees itself when it returns.
+	struct DetachedCoroutine
+	{
+		struct promise_type
+		{
+			auto get_return_object() noexcept -> DetachedCoroutine {
+				return DetachedCoroutine{std::coroutine_handle<promise_type>::from_promise(*this)};
+			}
+
+			auto initial_suspend() noexcept -> std::suspend_always {
+				return {};
+			}
+
+			auto final_suspend() noexcept -> std::suspend_never {
+				return {};
+			}
+
+			auto return_void() noexcept -> void {}
+
+			auto unhandled_exception() noexcept -> void {
+				std::terminate();
+			}
+
+			static auto operator new(const size_t size) -> void* {
+				return BlockCache::Allocate(size);
+			}
+
+			static auto operator delete(void* frame, const size_t size) -> void {
+				BlockCache::Deallocate(frame, size);
+			}
+		};
+
+		std::coroutine_handle<promise_type> handle;
+	};
+
+	/// \brief Collects the results of WhenAll; lives in the frame of the WhenAll coroutine.
+	template <typename T> struct AllState
+	{
+		explicit AllState(const size_t count) : results(count), remaining(count + 1) {}
+
+		auto Complete(const size_t index, std::optional<Stored<T>> value, std::exception_ptr error) -> void {
+			if (error) {
+				if (!failed.exchange(true)) {
+					this->error = std::move(error);
+				}
+			}
+			else {
+				results[index] = std::move(value);
+			}
+			if (remaining.fetch_sub(1) == 1) {
+				continuation.resume();
+			}
+		}
+
+		std::vector<std::optional<Stored<T>>> results;
+		std::atomic<size_t> remaining;
+		std::atomic<bool> failed{false};
+		std::exception_ptr error;
+		std::coroutine_handle<> continuation;
+	};
+
+	/// \brief Records the first result of WhenAny; shared with the tasks that are still running.
+	template <typename T> struct AnyState
+	{
+		auto Complete(const size_t index, std::optional<Stored<T>> value, std::exception_ptr error) -> void {
+			if (decided.exchange(true)) return;
+			winner = index;
+			result = std::move(value);
+			this->error = std::move(error);
+			if (gate.fetch_sub(1) == 1) {
+				continuation.resume();
+			}
+		}
+
+		std::atomic<bool> decided{false};
+		std::atomic<int> gate{2};
+		size_t winner{0};
+		std::optional<Stored<T>> result;
+		std::exception_ptr error;
+		std::coroutine_handle<> continuation;
+	};
+
+	/// \brief Receives the result of SyncWait and wakes the blocked thread.
+	template <typename T> struct SyncState
+	{
+		auto Complete(size_t, std::optional<Stored<T>> value, std::exception_ptr error) -> void {
+			// Notifying under the lock keeps the state alive until the waiter has been told.
+			std::lock_guard lock(mutex);
+			result = std::move(value);
+			this->error = std::move(error);
+			done = true;
+			condition.notify_one();
+		}
+
+		std::optional<Stored<T>> result;
+		std::exception_ptr error;
+		std::mutex mutex;
+		std::condition_variable condition;
+		bool done{false};
+	};
+
+	/// \brief Starts a set of children and suspends the awaiting coroutine unless they all finished already.
+	template <typename Gate> struct StartAwaiter
+	{
+		std::vector<DetachedCoroutine>& children;
+		std::coroutine_handle<>& continuation;
+		Gate& gate;
+
+		[[nodiscard]] auto await_ready() const noexcept -> bool {
+			return false;
+		}
+
+		auto await_suspend(const std::coroutine_handle<> awaiting) -> bool {
+			continuation = awaiting;
+			for (const auto& child : children) {
+				child.handle.resume();
+			}
+			// The gate holds one extra count for this loop, so a child finishing early cannot resume
+			// the awaiting coroutine before every child has been started.
+			return gate.fetch_sub(1) != 1;
+		}
+
+		auto await_resume() noexcept -> void {}
+	};
+
+	template <typename T, typename StatePtr> static auto RunChild(Task<T> task, StatePtr state, size_t index) -> DetachedCoroutine;
+	template <typename T> static auto TakeResult(std::optional<Stored<T>>& result, const std::exception_ptr& error) -> T;
+};
+
+/// \brief Awaits a task and reports its outcome to a state object.
+/// \tparam T The result type of the task.
+/// \tparam StatePtr A pointer to a state with Complete(index, value, error).
+/// \param task The task to run.
+/// \param state The state to report to; a shared pointer keeps it alive for the child.
+/// \param index The position of the task in its group.
+template <typename T, typename StatePtr> auto TaskUtil::RunChild(Task<T> task, StatePtr state, const size_t index) -> DetachedCoroutine {
+	std::optional<Stored<T>> value;
+	std::exception_ptr error;
+	try {
+		if constexpr (std::is_void_v<T>) {
+			co_await std::move(task);
+			value.emplace();
+		}
+		else {
+			value.emplace(co_await std::move(task));
+		}
+	}
+	catch (...) {
+		error = std::current_exception();
+	}
+	state->Complete(index, std::move(value), std::move(error));
+}
+
+/// \brief Returns a stored result, or rethrows the stored exception.
+template <typename T> auto TaskUtil::TakeResult(std::optional<Stored<T>>& result, const std::exception_ptr& error) -> T {
+	if (error) {
+		std::rethrow_exception(error);
+	}
+	if constexpr (!std::is_void_v<T>) {
+		return std::move(*result);
+	}
+}
+
+/// \brief Runs tasks concurrently and waits for all of them.
+/// \tparam T The result type of the tasks.
+/// \param tasks The tasks to run.
+/// \return A task producing the results in the order of \p tasks, or nothing for void tasks. If any task
+/// throws, the first exception is rethrown once every task has finished.
+template <typename T> auto TaskUtil::WhenAll(std::vector<Task<T>> tasks) -> Task<std::conditional_t<std::is_void_v<T>, void, std::vector<T>>> {
+	AllState<T> state(tasks.size());
+	std::vector<DetachedCoroutine> children;
+	children.reserve(tasks.size());
+	for (size_t i = 0; i < tasks.size(); ++i) {
+		children.push_back(RunChild(std::move(tasks[i]), &state, i));
+	}
+	co_await StartAwaiter<std::atomic<size_t>>{children, state.continuation, state.remaining};
+	if (state.error) {
+		std::rethrow_exception(state.error);
+	}
+	if constexpr (!std::is_void_v<T>) {
+		std::vector<T> results;
+		results.reserve(state.results.size());
+		for (auto& result : state.results) {
+			results.push_back(std::move(*result));
+		}
+		co_return results;
+	}
+}
+
+/// \brief Runs tasks concurrently and waits for the first one to finish.
+/// \tparam T The result type of the tasks.
+/// \param tasks The tasks to run, at least one.
+/// \return A task producing the index of the first task to finish together with its result, or just the
+/// index for void tasks. If that task threw, its exception is rethrown. The other tasks keep running to
+/// completion in the background and their outcomes are discarded.
+/// \throws std::invalid_argument if \p tasks is empty.
+template <typename T> auto TaskUtil::WhenAny(std::vector<Task<T>> tasks) -> Task<std::conditional_t<std::is_void_v<T>, size_t, std::pair<size_t, T>>> {
+	if (tasks.empty()) {
+		throw std::invalid_argument("WhenAny requires at least one task");
+	}
+	auto state = std::allocate_shared<AnyState<T>>(PooledAllocator<AnyState<T>>());
+	std::vector<DetachedCoroutine> children;
+	children.reserve(tasks.size());
+	for (size_t i = 0; i < tasks.size(); ++i) {
+		children.push_back(RunChild(std::move(tasks[i]), state, i));
+	}
+	co_await StartAwaiter<std::atomic<int>>{children, state->continuation, state->gate};
+	if constexpr (std::is_void_v<T>) {
+		TakeResult<T>(state->result, state->error);
+		co_return state->winner;
+	}
+	else {
+		co_return std::pair<size_t, T>(state->winner, TakeResult<T>(state->result, state->error));
+	}
+}
+
+/// \brief Blocks the calling thread until a task has finished.
+/// \tparam T The result type of the task.
+/// \param task The task to run; it starts on the calling thread.
+/// \return The result of the task.
+/// \throws Whatever the task throws.
+template <typename T> auto TaskUtil::SyncWait(Task<T> task) -> T {
+	SyncState<T> state;
+	RunChild(std::move(task), &state, 0).handle.resume();
+	{
+		std::unique_lock lock(state.mutex);
+		state.condition.wait(lock, [&state] {
+			return state.done;
+		});
+	}
+	return TakeResult<T>(state.result, state.error);
+}
+}
@@ -1,9 +1,20 @@
 // Created by author ethereal on 2024/11/20.
 // Copyright (c) 2024 ethereal. All rights reserved.
 #include "ThreadPool.hpp"
+#include <algorithm>
+#include <random>
+#include "Backoff.hpp"
 
 namespace common::thread
 {
+namespace
+{
+/// \brief The pool whose worker is running on the current thread, if any.
+thread_local const ThreadPool* currentPool = nullptr;
+/// \brief The worker slot of the current thread inside currentPool.
+thread_local size_t currentWorkerIndex = 0;
+}
+
 ///\brief A thread pool for executing tasks concurrently
 /// A thread pool is a software design pattern for achieving concurrency of
 /// tasks. It uses a group of worker threads that are maintained by the pool in
@@ -13,7 +24,23 @@ namespace common::thread
 /// involve waiting for events to occur, by reusing threads rather than
 /// creating and destroying them. The pool of threads is typically maintained
 /// by a manager that assigns tasks to the threads as they become available.
-ThreadPool::ThreadPool(const size_t core_threads, const size_t max_threads, const size_t queue_size, const std::chrono::milliseconds idle_time) : stop_(false), coreThreadCount_(core_threads), maxThreadCount_(max_threads), maxQueueSize_(queue_size), threadIdleTime_(idle_time) {
+ThreadPool::ThreadPool(const size_t core_threads, const size_t max_threads, const size_t queue_size, const std::chrono::milliseconds idle_time, const SchedulingMode mode) : createdAt_(std::chrono::steady_clock::now()), stop_(false), coreThreadCount_(core_threads), activeThreadCount_(0), maxThreadCount_(max_threads), maxQueueSize_(queue_size), threadIdleTime_(idle_time), mode_(mode) {
+	if (maxThreadCount_ == 0) {
+		throw std::invalid_argument("Maximum thread count must be greater than zero");
+	}
+	workers_.resize(maxThreadCount_);
+	for (size_t i = maxThreadCount_; i > 0; --i) {
+		freeSlots_.push_back(i - 1);
+	}
+	slots_.reserve(maxThreadCount_);
+	for (size_t i = 0; i < maxThreadCount_; ++i) {
+		slots_.push_back(std::make_unique<WorkerSlot>());
+	}
+	if (mode_ == SchedulingMode::LockFreeQueue) {
+		for (auto& queue : lockFreeQueues_) {
+			queue = std::make_unique<MpmcQueue<QueuedTask*>>(std::max<size_t>(maxQueueSize_, 1));
+		}
+	}
 	for (size_t i = 0; i < coreThreadCount_; ++i) {
 		AddWorker();
 	}
@@ -23,34 +50,7 @@ ThreadPool::ThreadPool(const size_t core_threads, const size_t max_threads, cons
 ///\details Shuts down all the threads and clears the task queue.
 ThreadPool::~ThreadPool() {
 	Shutdown();
-}
-
-/// \brief Submit a task to the thread pool for execution.
-/// \tparam F The type of the function to be executed.
-/// \tparam Args The types of the arguments to be passed to the function.
-/// \param f The function to be executed.
-/// \param args The arguments to be passed to the function.
-/// \return A future object that will hold the result of the function execution.
-/// \throws std::runtime_error if the task queue is full.
-/// \details This function creates a packaged task from the function and arguments
-/// and adds it to the task queue. If the queue is full, it throws an exception.
-/// A worker thread will eventually execute the task, and the result can be
-/// retrieved from the returned future object.
-template <class F, class... Args> auto ThreadPool::Submit(F&& f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>> {
-	using return_type = std::invoke_result_t<F, Args...>;
-	auto task = std::make_shared<std::packaged_task<return_type()>>(std::bind(std::forward<F>(f), std::forward<Args>(args)...));
-	std::future<return_type> res = task->get_future();
-	{
-		std::unique_lock lock(queueMutex_);
-		if (task_queue_.size() >= maxQueueSize_) {
-			throw std::runtime_error("Task queue is full");
-		}
-		task_queue_.emplace([task] {
-			(*task)();
-		});
-	}
-	condition_.notify_one();
-	return res;
+	DiscardLockFreeTasks();
 }
 
 /// \brief Shuts down all the threads in the pool.
@@ -58,76 +58,791 @@ template <class F, class... Args> auto ThreadPool::Submit(F&& f, Args&&... args)
 /// tasks and exit. It then waits for all the threads to finish and clears
 /// the task queue.
 auto ThreadPool::Shutdown() -> void {
+	StopStatsReporter();
 	{
 		std::unique_lock lock(queueMutex_);
 		stop_ = true;
 	}
 	condition_.notify_all();
-	for (std::thread& worker : workers_) {
-		if (worker.joinable()) worker.join();
-	}
+	spaceCondition_.notify_all();
+	JoinWorkers();
 }
 
 /// \brief Immediately shuts down the thread pool.
 /// \details This function sets the stop flag to true and clears the task queue.
 /// It notifies all worker threads to finish their current tasks and exit as soon as possible.
 /// This is a more abrupt shutdown compared to the regular Shutdown, as it discards all pending tasks.
+/// The discarded tasks are destroyed after queueMutex_ is released, so a DiscardGuard they own may call
+/// back into the pool.
 auto ThreadPool::ShutdownNow() -> void {
+	StopStatsReporter();
+	std::vector<TaskFunction> discarded;
 	{
 		std::unique_lock lock(queueMutex_);
 		stop_ = true;
-		while (!task_queue_.empty()) {
-			task_queue_.pop();
+		for (auto& queue : task_queues_) {
+			pendingTaskCount_ -= queue.size();
+			while (!queue.empty()) {
+				discarded.push_back(std::move(queue.front().task));
+				queue.pop();
+			}
 		}
+		urgentTaskCount_ = 0;
 	}
+	discarded.clear();
+	DiscardLockFreeTasks();
 	condition_.notify_all();
-	for (std::thread& worker : workers_) {
-		if (worker.joinable()) worker.join();
-	}
+	spaceCondition_.notify_all();
+	JoinWorkers();
 }
 
 /// \brief Executes tasks from the task queue.
-/// \details This function runs in a loop, waiting for tasks to be available in the task queue.
-/// It picks up tasks and executes them. If the thread pool is in the process of shutting down
-/// and there are no tasks left in the queue, the function exits.
-auto ThreadPool::Worker() -> void {
+/// \details This function runs in a loop, taking tasks from the worker's local deque, the shared
+/// queue and, in work-stealing mode, the deques of the other workers, and executes them. When no
+/// task can be found the worker parks on the condition variable. A worker that stays idle for
+/// threadIdleTime_ retires while the pool is above its core size. If the thread pool is in the
+/// process of shutting down and there are no tasks left, the function exits.
+/// \param index The slot of this worker.
+/// \param firstTask A task to run before looking at the queues, may be empty.
+auto ThreadPool::Worker(const size_t index, QueuedTask firstTask) -> void {
+	currentPool = this;
+	currentWorkerIndex = index;
+	WorkerMetrics& metrics = slots_[index]->metrics;
+	if (firstTask.task) {
+		RunTask(firstTask, metrics);
+		firstTask.task = {};
+	}
 	while (true) {
-		std::function<void()> task;
-		{
-			std::unique_lock lock(queueMutex_);
-			condition_.wait_for(lock, threadIdleTime_, [this] {
-				return stop_ || !task_queue_.empty();
-			});
-			if (stop_ && task_queue_.empty()) return;
-			if (task_queue_.empty() && activeThreadCount_ > coreThreadCount_) {
-				--activeThreadCount_;
-				return;
+		if (QueuedTask next; TakeTask(index, next)) {
+			RunTask(next, metrics);
+			continue;
+		}
+		std::unique_lock lock(queueMutex_);
+		++idleThreadCount_;
+		const bool signalled = condition_.wait_for(lock, threadIdleTime_, [this] {
+			return stop_ || pendingTaskCount_ > 0;
+		});
+		--idleThreadCount_;
+		if (stop_ && pendingTaskCount_ == 0) return;
+		if (!signalled) {
+			lock.unlock();
+			if (TryRetireWorker(index)) return;
+		}
+	}
+}
+
+/// \brief Runs a task on the calling worker and records its queueing and execution time.
+/// \details Tasks created by Submit report their exceptions through the future; an exception
+/// escaping an Execute task is discarded so that it cannot take the worker down.
+/// \param task The task to run.
+/// \param metrics The counters of the calling worker.
+auto ThreadPool::RunTask(QueuedTask& task, WorkerMetrics& metrics) -> void {
+	const auto start = std::chrono::steady_clock::now();
+	try {
+		task.task();
+	}
+	catch (...) {
+		// Fire-and-forget task failed; there is nobody to report to.
+	}
+	metrics.Record(start - task.enqueueTime, std::chrono::steady_clock::now() - start);
+}
+
+/// \brief Retires the calling worker if the pool is above its core size.
+/// \details The thread count is decremented with a compare-and-swap so that concurrent retirements
+/// never shrink the pool below coreThreadCount_. A task queued meanwhile cancels the retirement:
+/// its producer may have seen this worker still counted and started no other, and the thread count
+/// is published before the pending counter is read, so either side notices the other. The slot is
+/// queued for reaping; its std::thread is joined by the next AddWorker or retiring worker, or by Shutdown.
+/// \param index The slot of the calling worker.
+/// \return true if the worker must exit, false if it has to keep running.
+auto ThreadPool::TryRetireWorker(const size_t index) -> bool {
+	size_t count = activeThreadCount_.load();
+	do {
+		if (count <= coreThreadCount_) return false;
+	}
+	while (!activeThreadCount_.compare_exchange_weak(count, count - 1));
+	if (pendingTaskCount_ > 0) {
+		++activeThreadCount_;
+		return false;
+	}
+	std::lock_guard lock(workersMutex_);
+	ReapRetiredWorkers();
+	retiredSlots_.push_back(index);
+	return true;
+}
+
+/// \brief Joins the threads of retired workers and makes their slots reusable.
+/// \details Must be called with workersMutex_ held. A retired worker releases the mutex right before
+/// its thread function returns, so the joins complete almost immediately.
+auto ThreadPool::ReapRetiredWorkers() -> void {
+	for (const size_t slot : retiredSlots_) {
+		if (workers_[slot].joinable()) workers_[slot].join();
+		freeSlots_.push_back(slot);
+	}
+	retiredSlots_.clear();
+}
+
+/// \brief Pins the worker in a slot according to the configured affinity.
+/// \details Must be called with workersMutex_ held. Does nothing if no affinity is configured.
+/// \param index The slot of the worker.
+auto ThreadPool::ApplyAffinity(const size_t index) -> void {
+	if (affinityCpus_.empty() || !workers_[index].joinable()) return;
+	if (affinityMode_ == AffinityMode::PerCpu) {
+		CpuTopology::SetThreadAffinity(workers_[index], {affinityCpus_[index % affinityCpus_.size()]});
+	}
+	else {
+		CpuTopology::SetThreadAffinity(workers_[index], affinityCpus_);
+	}
+}
+
+/// \brief Joins every worker thread.
+/// \details The threads are moved out under workersMutex_ and joined outside of it, so that workers
+/// retiring concurrently can still register themselves.
+auto ThreadPool::JoinWorkers() -> void {
+	std::vector<std::thread> threads;
+	{
+		std::lock_guard lock(workersMutex_);
+		for (std::thread& worker : workers_) {
+			if (worker.joinable()) threads.push_back(std::move(worker));
+		}
+		retiredSlots_.clear();
+	}
+	for (std::thread& worker : threads) {
+		worker.join();
+	}
+}
+
+/// \brief Takes the next task this worker should run.
+/// \details The worker's own deque is drained first (newest task first, which keeps its data hot in
+/// cache), then the shared queues, and finally the other workers' deques are robbed. High priority
+/// tasks waiting in the shared queues are taken before the local deque. A task that sat in the shared
+/// queues for longer than the growth wait time lets the pool grow if work is still queued.
+/// \param index The slot of the calling worker.
+/// \param out Receives the task.
+/// \return true if a task was found, false otherwise.
+auto ThreadPool::TakeTask(const size_t index, QueuedTask& out) -> bool {
+	const bool workStealing = mode_ == SchedulingMode::WorkStealing;
+	const bool urgent = urgentTaskCount_ > 0;
+	if (workStealing && !urgent && PopLocalTask(index, out)) {
+		return true;
+	}
+	bool found;
+	if (mode_ == SchedulingMode::LockFreeQueue) {
+		found = PopLockFreeTask(out);
+	}
+	else {
+		std::unique_lock lock(queueMutex_);
+		found = PopSharedTask(out);
+	}
+	if (found) {
+		if (std::chrono::steady_clock::now() - out.enqueueTime >= growthWaitTime_.load()) {
+			GrowIfBacklogged(true);
+		}
+		return true;
+	}
+	if (workStealing) {
+		return (urgent && PopLocalTask(index, out)) || StealTask(index, out);
+	}
+	return false;
+}
+
+/// \brief Pops the newest task of the calling worker's local deque.
+/// \param index The slot of the calling worker.
+/// \param out Receives the task.
+/// \return true if a task was popped, false if the deque is empty.
+auto ThreadPool::PopLocalTask(const size_t index, QueuedTask& out) -> bool {
+	if (const auto local = slots_[index]->localQueue.Pop()) {
+		--pendingTaskCount_;
+		const std::unique_ptr<QueuedTask> owned(*local);
+		out = std::move(*owned);
+		return true;
+	}
+	return false;
+}
+
+/// \brief Pops the next task from the shared priority queues.
+/// \details Must be called with queueMutex_ held. Every queue is FIFO, so its front is its oldest
+/// task. A task is promoted by one level for every agingInterval_ it has been waiting, and the front
+/// with the best effective level wins, ties going to the higher base priority. This way low priority
+/// work keeps moving even while high priority tasks arrive continuously.
+/// \param out Receives the task.
+/// \return true if a task was popped, false if all queues are empty.
+auto ThreadPool::PopSharedTask(QueuedTask& out) -> bool {
+	const auto now = std::chrono::steady_clock::now();
+	const auto aging = agingInterval_.load();
+	size_t best = PRIORITY_LEVELS;
+	long long bestRank = 0;
+	for (size_t level = 0; level < PRIORITY_LEVELS; ++level) {
+		if (task_queues_[level].empty()) continue;
+		const long long promotion = aging.count() > 0 ? (now - task_queues_[level].front().enqueueTime) / aging : 0;
+		if (const long long rank = static_cast<long long>(level) - promotion; best == PRIORITY_LEVELS || rank < bestRank) {
+			best = level;
+			bestRank = rank;
+		}
+	}
+	if (best == PRIORITY_LEVELS) return false;
+	out = std::move(task_queues_[best].front());
+	task_queues_[best].pop();
+	--pendingTaskCount_;
+	if (blockedProducerCount_ > 0) {
+		spaceCondition_.notify_one();
+	}
+	if (best == static_cast<size_t>(TaskPriority::High)) {
+		--urgentTaskCount_;
+	}
+	return true;
+}
+
+/// \brief Pops the next task from the lock-free shared rings.
+/// \details The rings cannot be inspected without popping, so instead of aging the calling worker
+/// scans the levels from High to Low, except that every LOCK_FREE_ROTATION_PERIOD-th scan starts at
+/// the next level in turn. Each level is thus served at least that often even under sustained load.
+/// \param out Receives the task.
+/// \return true if a task was popped, false if all rings are empty.
+auto ThreadPool::PopLockFreeTask(QueuedTask& out) -> bool {
+	thread_local size_t scanCount = 0;
+	++scanCount;
+	const size_t first = scanCount % LOCK_FREE_ROTATION_PERIOD == 0 ? scanCount / LOCK_FREE_ROTATION_PERIOD % PRIORITY_LEVELS : 0;
+	for (size_t i = 0; i < PRIORITY_LEVELS; ++i) {
+		if (const auto task = lockFreeQueues_[(first + i) % PRIORITY_LEVELS]->TryPop()) {
+			--pendingTaskCount_;
+			if (blockedProducerCount_ > 0) {
+				{
+					std::lock_guard lock(queueMutex_);
+				}
+				spaceCondition_.notify_one();
 			}
-			if (!task_queue_.empty()) {
-				task = std::move(task_queue_.front());
-				task_queue_.pop();
+			const std::unique_ptr<QueuedTask> owned(*task);
+			out = std::move(*owned);
+			return true;
+		}
+	}
+	return false;
+}
+
+/// \brief Reserves room for tasks in the lock-free shared rings.
+/// \details pendingTaskCount_ counts exactly the tasks in the rings in this mode, so a successful
+/// reservation bounds the number of queued tasks by maxQueueSize_. It does not make a push succeed at
+/// once: the ring refuses a push while a consumer has claimed the slot ahead but not released its
+/// sequence number yet. PushLockFreeTask waits that out.
+/// \param count The number of tasks to add.
+/// \return true if the tasks fit, false if they would exceed maxQueueSize_.
+auto ThreadPool::ReserveLockFreeSlots(const size_t count) -> bool {
+	size_t pending = pendingTaskCount_.load();
+	do {
+		if (pending + count > maxQueueSize_) return false;
+	}
+	while (!pendingTaskCount_.compare_exchange_weak(pending, pending + count));
+	return true;
+}
+
+/// \brief Pushes a task into a lock-free ring after room for it has been reserved.
+/// \details With the reservation held the ring can only be full transiently, until a consumer that has
+/// claimed a slot publishes its release, which it does without blocking. The push is therefore retried,
+/// spinning with backoff and then yielding, rather than rejected.
+/// \param queue The ring.
+/// \param task The task, owned by the ring once pushed.
+auto ThreadPool::PushLockFreeTask(MpmcQueue<QueuedTask*>& queue, QueuedTask* task) -> void {
+	Backoff backoff;
+	while (!queue.TryPush(task)) {
+		if (backoff.Exhausted()) {
+			std::this_thread::yield();
+		}
+		else {
+			backoff.Pause();
+		}
+	}
+}
+
+/// \brief Returns the number of tasks in the shared queues.
+/// \details Must be called with queueMutex_ held.
+auto ThreadPool::SharedQueueSize() const -> size_t {
+	size_t size = 0;
+	for (const auto& queue : task_queues_) {
+		size += queue.size();
+	}
+	return size;
+}
+
+/// \brief Steals a task from another worker's deque.
+/// \details Victims are visited in order starting at a random slot so that thieves spread out
+/// instead of all hitting the same deque.
+/// \param index The slot of the calling worker, which is skipped.
+/// \param out Receives the stolen task.
+/// \return true if a task was stolen, false if every deque was empty.
+auto ThreadPool::StealTask(const size_t index, QueuedTask& out) -> bool {
+	thread_local std::minstd_rand random(static_cast<unsigned>(std::hash<std::thread::id>{}(std::this_thread::get_id())));
+	const size_t slotCount = slots_.size();
+	if (slotCount < 2) return false;
+	const size_t start = random() % slotCount;
+	for (size_t i = 0; i < slotCount; ++i) {
+		const size_t victim = (start + i) % slotCount;
+		if (victim == index) continue;
+		if (const auto stolen = slots_[victim]->localQueue.Steal()) {
+			--pendingTaskCount_;
+			const std::unique_ptr<QueuedTask> owned(*stolen);
+			out = std::move(*owned);
+			return true;
+		}
+	}
+	return false;
+}
+
+/// \brief Adds a task to the pool.
+/// \param task The task to add.
+/// \param priority The priority of the task.
+/// \throws std::runtime_error if the task is rejected.
+auto ThreadPool::Enqueue(TaskFunction task, const TaskPriority priority) -> void {
+	if (!TryEnqueue(task, priority)) {
+		throw std::runtime_error("Task queue is full");
+	}
+}
+
+/// \brief Adds a task to the pool, applying the rejection policy if it does not fit.
+/// \param task The task to add; it is only moved from if it was accepted.
+/// \param priority The priority of the task.
+/// \return true if the task was accepted, false if it was rejected.
+auto ThreadPool::TryEnqueue(TaskFunction& task, const TaskPriority priority) -> bool {
+	if (PushTask(task, priority) || ApplyRejectionPolicy(task, priority)) {
+		return true;
+	}
+	++rejectedTaskCount_;
+	return false;
+}
+
+/// \brief Pushes a task into the queues, or hands it to a new worker if they are full.
+/// \details In work-stealing mode a normal priority task submitted by one of the pool's workers is
+/// pushed to that worker's local deque without taking any lock. Every other task goes to the shared
+/// queue of its priority, which is a lock-free ring in lock-free mode. When the shared queues are
+/// full the task is handed straight to a new worker if the pool can still grow.
+/// \param task The task to add; it is only moved from if it was accepted.
+/// \param priority The priority of the task.
+/// \return true if the task was accepted, false if the queues are full and the pool is at max_threads.
+auto ThreadPool::PushTask(TaskFunction& task, const TaskPriority priority) -> bool {
+	const auto now = std::chrono::steady_clock::now();
+	if (mode_ == SchedulingMode::WorkStealing && currentPool == this && priority == TaskPriority::Normal) {
+		++pendingTaskCount_;
+		slots_[currentWorkerIndex]->localQueue.Push(new QueuedTask{std::move(task), now});
+		NotifyIdleWorkers(1);
+		GrowIfBacklogged();
+		return true;
+	}
+	bool queued = false;
+	if (mode_ == SchedulingMode::LockFreeQueue) {
+		if (ReserveLockFreeSlots(1)) {
+			PushLockFreeTask(*lockFreeQueues_[static_cast<size_t>(priority)], new QueuedTask{std::move(task), now});
+			NotifyIdleWorkers(1);
+			GrowIfBacklogged();
+			return true;
+		}
+	}
+	else {
+		std::unique_lock lock(queueMutex_);
+		if (SharedQueueSize() < maxQueueSize_) {
+			task_queues_[static_cast<size_t>(priority)].push({std::move(task), now});
+			++pendingTaskCount_;
+			if (priority == TaskPriority::High) {
+				++urgentTaskCount_;
 			}
+			queued = true;
 		}
-		if (task) {
+	}
+	if (queued) {
+		condition_.notify_one();
+		GrowIfBacklogged();
+		return true;
+	}
+	return AddWorker(task);
+}
+
+/// \brief Tries to place a task that did not fit, according to the rejection policy.
+/// \param task The task; it is only moved from if it was accepted.
+/// \param priority The priority of the task.
+/// \return true if the task was accepted or run, false if it is rejected.
+auto ThreadPool::ApplyRejectionPolicy(TaskFunction& task, const TaskPriority priority) -> bool {
+	switch (rejectionPolicy_.load()) {
+	case RejectionPolicy::Block: {
+		const auto deadline = std::chrono::steady_clock::now() + blockTimeout_.load();
+		while (WaitForRoom(deadline)) {
+			if (PushTask(task, priority)) return true;
+		}
+		return false;
+	}
+	case RejectionPolicy::CallerRuns:
+		try {
 			task();
 		}
+		catch (...) {
+			// Same as on a worker: an Execute task has nobody to report to.
+		}
+		return true;
+	case RejectionPolicy::DiscardOldest:
+		while (DiscardOldestTask()) {
+			if (PushTask(task, priority)) return true;
+		}
+		return false;
+	case RejectionPolicy::Throw:
+	default:
+		return false;
+	}
+}
+
+/// \brief Blocks the calling producer until the shared queues have room.
+/// \details A producer registers in blockedProducerCount_ under queueMutex_ before checking for room,
+/// and a worker that frees room reads the counter after doing so and notifies under the same mutex,
+/// so the wake-up cannot be lost.
+/// \param deadline When to give up.
+/// \return true if there is room now, false on timeout or shutdown.
+auto ThreadPool::WaitForRoom(const std::chrono::steady_clock::time_point deadline) -> bool {
+	std::unique_lock lock(queueMutex_);
+	++blockedProducerCount_;
+	const bool room = spaceCondition_.wait_until(lock, deadline, [this] {
+		return stop_ || HasRoom();
+	});
+	--blockedProducerCount_;
+	return room && !stop_;
+}
+
+/// \brief Drops the oldest task of the lowest non-empty priority level of the shared queues.
+/// \details The future of the dropped task reports a broken promise; an Execute task learns of it
+/// through a DiscardGuard, whose callback runs here after queueMutex_ is released. Tasks in the
+/// workers' local deques are never dropped.
+/// \return true if a task was dropped, false if the shared queues are empty.
+auto ThreadPool::DiscardOldestTask() -> bool {
+	if (mode_ == SchedulingMode::LockFreeQueue) {
+		for (size_t level = PRIORITY_LEVELS; level > 0; --level) {
+			if (const auto task = lockFreeQueues_[level - 1]->TryPop()) {
+				--pendingTaskCount_;
+				++rejectedTaskCount_;
+				delete *task;
+				return true;
+			}
+		}
+		return false;
+	}
+	TaskFunction dropped;
+	{
+		std::unique_lock lock(queueMutex_);
+		for (size_t level = PRIORITY_LEVELS; level > 0 && !dropped; --level) {
+			auto& queue = task_queues_[level - 1];
+			if (queue.empty()) continue;
+			dropped = std::move(queue.front().task);
+			queue.pop();
+			--pendingTaskCount_;
+			if (level - 1 == static_cast<size_t>(TaskPriority::High)) {
+				--urgentTaskCount_;
+			}
+		}
+	}
+	if (!dropped) return false;
+	++rejectedTaskCount_;
+	return true;
+}
+
+/// \brief Returns whether the shared queues can take another task.
+/// \details Must be called with queueMutex_ held unless the pool is in lock-free mode.
+auto ThreadPool::HasRoom() const -> bool {
+	if (mode_ == SchedulingMode::LockFreeQueue) {
+		return pendingTaskCount_ < maxQueueSize_;
+	}
+	return SharedQueueSize() < maxQueueSize_;
+}
+
+/// \brief Adds a batch of tasks to the pool.
+/// \details The whole batch is pushed under a single acquisition of queueMutex_ (or, from a worker
+/// in work-stealing mode, to that worker's local deque without any lock, and in lock-free mode to
+/// the normal priority ring after a single reservation), after which only as many
+/// parked workers are woken as there are new tasks. The batch is accepted completely or not at all.
+/// \param tasks The tasks to add; they are moved from.
+/// \throws std::runtime_error if the shared task queue cannot hold the whole batch.
+auto ThreadPool::EnqueueBatch(std::vector<TaskFunction>& tasks) -> void {
+	const size_t count = tasks.size();
+	if (count == 0) return;
+	const auto now = std::chrono::steady_clock::now();
+	if (mode_ == SchedulingMode::WorkStealing && currentPool == this) {
+		pendingTaskCount_ += count;
+		auto& localQueue = slots_[currentWorkerIndex]->localQueue;
+		for (TaskFunction& task : tasks) {
+			localQueue.Push(new QueuedTask{std::move(task), now});
+		}
+	}
+	else if (mode_ == SchedulingMode::LockFreeQueue) {
+		if (!ReserveLockFreeSlots(count)) {
+			rejectedTaskCount_ += count;
+			throw std::runtime_error("Task queue is full");
+		}
+		auto& queue = *lockFreeQueues_[static_cast<size_t>(TaskPriority::Normal)];
+		for (TaskFunction& task : tasks) {
+			PushLockFreeTask(queue, new QueuedTask{std::move(task), now});
+		}
+	}
+	else {
+		std::unique_lock lock(queueMutex_);
+		if (SharedQueueSize() + count > maxQueueSize_) {
+			rejectedTaskCount_ += count;
+			throw std::runtime_error("Task queue is full");
+		}
+		auto& queue = task_queues_[static_cast<size_t>(TaskPriority::Normal)];
+		for (TaskFunction& task : tasks) {
+			queue.push({std::move(task), now});
+		}
+		pendingTaskCount_ += count;
+	}
+	NotifyIdleWorkers(count);
+	GrowIfBacklogged();
+}
+
+/// \brief Starts an extra worker when tasks are piling up.
+/// \details The pool grows towards max_threads while no worker is parked and at least
+/// growthQueueDepth_ tasks are waiting, or any task is waiting when the caller observed
+/// a task that sat in the queue for longer than growthWaitTime_ or when there is no worker at all,
+/// as in a pool with no core threads whose extra workers have all retired.
+/// \param queueDelayed Whether the caller observed an excessive queueing delay.
+auto ThreadPool::GrowIfBacklogged(const bool queueDelayed) -> void {
+	const size_t active = activeThreadCount_;
+	if (idleThreadCount_ > 0 || active >= maxThreadCount_) return;
+	if (pendingTaskCount_ >= (queueDelayed || active == 0 ? 1 : growthQueueDepth_.load())) {
+		AddWorker();
+	}
+}
+
+/// \brief Wakes up to \p count parked workers.
+/// \details The pending counter is published before idleThreadCount_ is read, and a parking worker
+/// publishes itself as idle before re-checking the counter under queueMutex_, so taking the mutex
+/// here before notifying guarantees the wake-up cannot be lost. Workers that are busy will find the
+/// new tasks on their own, so at most one notification per idle worker is sent.
+/// \param count The number of tasks that were just made available.
+auto ThreadPool::NotifyIdleWorkers(const size_t count) -> void {
+	const size_t idle = idleThreadCount_;
+	if (idle == 0) return;
+	{
+		std::lock_guard lock(queueMutex_);
+	}
+	if (count >= idle) {
+		condition_.notify_all();
+		return;
+	}
+	for (size_t i = 0; i < count; ++i) {
+		condition_.notify_one();
+	}
+}
+
+/// \brief Destroys every task still waiting in the workers' local deques and the lock-free shared rings.
+/// \details Used by ShutdownNow and the destructor; the futures of the discarded tasks report a broken promise.
+auto ThreadPool::DiscardLockFreeTasks() -> void {
+	for (const auto& slot : slots_) {
+		while (!slot->localQueue.Empty()) {
+			if (const auto task = slot->localQueue.Steal()) {
+				--pendingTaskCount_;
+				delete *task;
+			}
+		}
+	}
+	for (const auto& queue : lockFreeQueues_) {
+		if (!queue) continue;
+		while (const auto task = queue->TryPop()) {
+			--pendingTaskCount_;
+			delete *task;
+		}
 	}
 }
 
 /// \brief Adds a new worker thread to the pool.
-/// \details This function creates a new worker thread and adds it to the pool.
-/// The new thread will execute tasks from the task queue.
+/// \details This function creates a new worker thread in a free slot and adds it to the pool.
+/// The new thread will execute tasks from the task queue. Retired workers are reaped first so
+/// their slots can be reused.
+/// \param firstTask A task the new worker runs before looking at the queues, may be empty.
 /// \return true if the thread was added successfully, false otherwise.
 /// \details The function returns false if the current number of active threads
-/// is already at the maximum allowed number.
-auto ThreadPool::AddWorker() -> bool {
-	if (activeThreadCount_ >= maxThreadCount_) {
+/// is already at the maximum allowed number or the pool is shutting down; \p firstTask
+/// is only moved from if the thread was added.
+auto ThreadPool::AddWorker(TaskFunction& firstTask) -> bool {
+	size_t count = activeThreadCount_.load();
+	do {
+		if (count >= maxThreadCount_) return false;
+	}
+	while (!activeThreadCount_.compare_exchange_weak(count, count + 1));
+	std::lock_guard lock(workersMutex_);
+	ReapRetiredWorkers();
+	if (stop_ || freeSlots_.empty()) {
+		--activeThreadCount_;
 		return false;
 	}
-	++activeThreadCount_;
-	workers_.emplace_back([this] {
-		Worker();
+	const size_t index = freeSlots_.back();
+	freeSlots_.pop_back();
+	workers_[index] = std::thread([this, index, firstTask = QueuedTask{std::move(firstTask), std::chrono::steady_clock::now()}]() mutable {
+		Worker(index, std::move(firstTask));
 	});
+	ApplyAffinity(index);
 	return true;
 }
+
+/// \brief Adds a new worker thread without a first task.
+/// \return true if the thread was added successfully, false otherwise.
+auto ThreadPool::AddWorker() -> bool {
+	TaskFunction none;
+	return AddWorker(none);
+}
+
+/// \brief Allocates a queued task from the calling thread's block cache.
+/// \param size The size of the object.
+auto ThreadPool::QueuedTask::operator new(const size_t size) -> void* {
+	return BlockCache::Allocate(size);
+}
+
+/// \brief Returns a queued task to the calling thread's block cache.
+/// \param block The object storage.
+/// \param size The size of the object.
+auto ThreadPool::QueuedTask::operator delete(void* block, const size_t size) -> void {
+	BlockCache::Deallocate(block, size);
+}
+
+/// \brief Sets when the pool starts workers beyond its core size.
+/// \details A new worker is started, up to max_threads, when no worker is idle and either at least
+/// \p queueDepth tasks are waiting or a worker dequeues a task that waited at least \p waitTime.
+/// \param queueDepth The number of waiting tasks that triggers growth.
+/// \param waitTime The queueing delay that triggers growth.
+auto ThreadPool::SetGrowthThresholds(const size_t queueDepth, const std::chrono::milliseconds waitTime) -> void {
+	growthQueueDepth_ = queueDepth;
+	growthWaitTime_ = waitTime;
+}
+
+/// \brief Sets how fast waiting tasks gain priority.
+/// \details A queued task is treated as one priority level higher for every \p interval it has been
+/// waiting, which protects low priority tasks from starvation. Zero disables aging.
+/// \param interval The waiting time per promoted level.
+auto ThreadPool::SetAgingInterval(const std::chrono::milliseconds interval) -> void {
+	agingInterval_ = interval;
+}
+
+/// \brief Restricts the workers to a set of CPUs.
+/// \details Running workers are re-pinned immediately and workers started later are pinned as they
+/// start. CPU numbers are those of the operating system, see CpuTopology. Pinning is best effort: a CPU
+/// outside the process's affinity mask, or a platform without thread affinity, leaves the worker
+/// unpinned. An empty list stops pinning new workers but leaves the running ones where they are.
+/// \param cpus The CPUs to use.
+/// \param mode Whether each worker gets one CPU of the list or may use all of them.
+auto ThreadPool::SetWorkerAffinity(std::vector<size_t> cpus, const AffinityMode mode) -> void {
+	std::lock_guard lock(workersMutex_);
+	affinityCpus_ = std::move(cpus);
+	affinityMode_ = mode;
+	for (size_t index = 0; index < workers_.size(); ++index) {
+		ApplyAffinity(index);
+	}
+}
+
+/// \brief Sets what happens to tasks that do not fit into the full task queue.
+/// \details The policy applies to single tasks; a batch that does not fit is always rejected as a
+/// whole. Blocking from inside a worker is allowed but delays the worker's own tasks, so prefer a short
+/// timeout or CallerRuns for tasks that submit further work. DiscardOldest cannot be combined with
+/// Schedule, see there.
+/// \param policy The rejection policy.
+/// \param blockTimeout How long RejectionPolicy::Block waits for room before rejecting the task.
+auto ThreadPool::SetRejectionPolicy(const RejectionPolicy policy, const std::chrono::milliseconds blockTimeout) -> void {
+	rejectionPolicy_ = policy;
+	blockTimeout_ = blockTimeout;
+}
+
+/// \brief Takes a snapshot of the pool's state and counters.
+/// \details Only relaxed loads are used, so the snapshot is cheap but counters updated concurrently may
+/// be slightly out of step with each other. Worker slots that never ran a task are omitted from the
+/// per-worker list.
+/// \return The snapshot.
+auto ThreadPool::GetStats() const -> ThreadPoolStats {
+	ThreadPoolStats stats;
+	stats.poolSize = activeThreadCount_;
+	stats.idleThreads = idleThreadCount_;
+	stats.queuedTasks = pendingTaskCount_;
+	stats.rejectedTasks = rejectedTaskCount_;
+	stats.uptime = std::chrono::steady_clock::now() - createdAt_;
+	for (const auto& slot : slots_) {
+		const WorkerStats worker = slot->metrics.Snapshot(stats.uptime);
+		if (worker.tasksExecuted == 0) continue;
+		stats.completedTasks += worker.tasksExecuted;
+		stats.workers.push_back(worker);
+		slot->metrics.MergeHistogramsInto(stats);
+	}
+	return stats;
+}
+
+/// \brief Calls a function with a fresh stats snapshot at a fixed period.
+/// \details The callback runs on a dedicated reporter thread, which is stopped by Shutdown and
+/// ShutdownNow. Passing an empty callback stops reporting. The callback must not shut the pool down.
+/// This function must not be called concurrently with itself.
+/// \param callback The function receiving the snapshots.
+/// \param period The interval between two calls.
+auto ThreadPool::SetStatsCallback(std::function<void(const ThreadPoolStats&)> callback, const std::chrono::milliseconds period) -> void {
+	StopStatsReporter();
+	if (!callback || period.count() <= 0) return;
+	{
+		std::lock_guard lock(statsMutex_);
+		statsCallback_ = std::move(callback);
+		statsPeriod_ = period;
+		statsReporterStop_ = false;
+	}
+	statsReporter_ = std::thread([this] {
+		std::unique_lock lock(statsMutex_);
+		while (!statsCondition_.wait_for(lock, statsPeriod_, [this] {
+			return statsReporterStop_;
+		})) {
+			lock.unlock();
+			statsCallback_(GetStats());
+			lock.lock();
+		}
+	});
+}
+
+/// \brief Stops the stats reporter thread if it is running.
+auto ThreadPool::StopStatsReporter() -> void {
+	{
+		std::lock_guard lock(statsMutex_);
+		statsReporterStop_ = true;
+	}
+	statsCondition_.notify_all();
+	if (statsReporter_.joinable()) {
+		statsReporter_.join();
+	}
+}
+
+/// \brief Returns an awaitable that moves the awaiting coroutine onto a worker of the pool.
+/// \details co_await pool.Schedule() suspends the coroutine and queues its resumption like a task
+/// submitted with Execute, so it honours the scheduling mode and backpressure of the pool. If the
+/// pool is shut down before a worker picks it up, the coroutine is never resumed. Awaiting it fails on a
+/// pool using the DiscardOldest rejection policy, and the policy must not be switched to DiscardOldest
+/// while coroutines are waiting for a worker.
+/// \return The awaitable.
+auto ThreadPool::Schedule() noexcept -> ScheduleOperation {
+	return ScheduleOperation(*this);
+}
+
+ThreadPool::ScheduleOperation::ScheduleOperation(ThreadPool& pool) noexcept : pool_(pool) {}
+
+/// \brief Always suspends, the coroutine has to move to a worker.
+auto ThreadPool::ScheduleOperation::await_ready() const noexcept -> bool {
+	return false;
+}
+
+/// \brief Queues the resumption of the suspended coroutine.
+/// \details A pool using the DiscardOldest rejection policy is refused, as a discarded resumption would
+/// leave the coroutine suspended forever and leak its frame.
+/// \param handle The suspended coroutine.
+/// \throws std::logic_error if the pool uses the DiscardOldest rejection policy.
+/// \throws std::runtime_error if the task queue is full. In both cases the coroutine resumes on the
+/// calling thread with the exception.
+auto ThreadPool::ScheduleOperation::await_suspend(const std::coroutine_handle<> handle) const -> void {
+	if (pool_.rejectionPolicy_.load() == RejectionPolicy::DiscardOldest) {
+		throw std::logic_error("Schedule is not supported with the DiscardOldest rejection policy");
+	}
+	pool_.Execute([handle] {
+		handle.resume();
+	});
+}
+
+auto ThreadPool::ScheduleOperation::await_resume() const noexcept -> void {}
+
+/// \brief Returns the current number of worker threads.
+/// \return The number of workers, between core_threads and max_threads once the pool is running.
+auto ThreadPool::GetPoolSize() const -> size_t {
+	return activeThreadCount_;
+}
 }
@@ -1,14 +1,25 @@
 // Created by author ethereal on 2024/11/20.
 // Copyright (c) 2024 ethereal. All rights reserved.
 #pragma once
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <coroutine>
+#include <deque>
 #include <functional>
 #include <future>
+#include <memory>
+#include <optional>
 #include <queue>
 #include <thread>
 #include <vector>
+#include "BoundedQueue.hpp"
+#include "CpuTopology.hpp"
+#include "PooledAllocator.hpp"
+#include "TaskFunction.hpp"
+#include "ThreadPoolStats.hpp"
+#include "WorkStealingQueue.hpp"
 
 namespace common::thread
 {
@@ -24,17 +35,160 @@ namespace common::thread
 class ThreadPool
 {
 public:
-	ThreadPool(size_t core_threads, size_t max_threads, size_t queue_size, std::chrono::milliseconds idle_time);
+	/// \brief How submitted tasks are distributed over the worker threads.
+	/// \details SharedQueue funnels every task through one mutex protected queue. WorkStealing additionally
+	/// gives each worker a lock-free local deque: tasks submitted from inside a worker go to that worker's
+	/// deque and idle workers steal from the other end, so fan-out workloads do not contend on one lock.
+	/// LockFreeQueue replaces the mutex protected queues by bounded lock-free rings preallocated with
+	/// queue_size slots each, so submitting and taking tasks never blocks on a lock. In this mode the
+	/// priorities are served in order and every level periodically gets a turn instead of aging.
+	enum class SchedulingMode
+	{
+		SharedQueue,
+		WorkStealing,
+		LockFreeQueue
+	};
+
+	/// \brief The priority of a task in the shared queues.
+	/// \details Higher priority tasks are dequeued first; waiting tasks are promoted over time so that
+	/// lower priorities cannot starve (see SetAgingInterval).
+	enum class TaskPriority
+	{
+		High,
+		Normal,
+		Low
+	};
+
+	/// \brief Per-task scheduling options.
+	/// \details A task whose deadline has passed by the time a worker picks it up is not run; its
+	/// future reports a std::runtime_error instead.
+	struct TaskOptions
+	{
+		TaskPriority priority{TaskPriority::Normal};
+		std::optional<std::chrono::steady_clock::time_point> deadline;
+	};
+
+	/// \brief The awaiter returned by Schedule.
+	class ScheduleOperation
+	{
+	public:
+		explicit ScheduleOperation(ThreadPool& pool) noexcept;
+		[[nodiscard]] auto await_ready() const noexcept -> bool;
+		auto await_suspend(std::coroutine_handle<> handle) const -> void;
+		auto await_resume() const noexcept -> void;
+
+	private:
+		ThreadPool& pool_;
+	};
+
+	/// \brief What happens to a task that does not fit into the full task queue of a pool at max_threads.
+	/// \details Throw rejects it, which makes Submit and Execute throw. Block makes the submitting
+	/// thread wait for room up to the block timeout, then rejects it. CallerRuns runs it on the
+	/// submitting thread, which slows the producer down to the pace of the pool. DiscardOldest drops
+	/// the oldest task of the lowest non-empty priority level, whose future reports a broken promise,
+	/// to make room for the new one; a dropped Execute task has no future, so a submitter that must
+	/// know captures a DiscardGuard in it. TrySubmit and TryExecute never throw; they report a rejection
+	/// through their return value.
+	enum class RejectionPolicy
+	{
+		Throw,
+		Block,
+		CallerRuns,
+		DiscardOldest
+	};
+
+	/// \brief How SetWorkerAffinity maps workers onto CPUs.
+	/// \details PerCpu pins the worker in slot i to the i-th CPU of the list, wrapping around, so each
+	/// worker keeps its caches warm on one core. CpuSet lets every worker run on any CPU of the list,
+	/// which keeps them on a socket while the scheduler still balances them.
+	enum class AffinityMode
+	{
+		PerCpu,
+		CpuSet
+	};
+
+	ThreadPool(size_t core_threads, size_t max_threads, size_t queue_size, std::chrono::milliseconds idle_time, SchedulingMode mode = SchedulingMode::SharedQueue);
 	~ThreadPool();
 	template <class F, class... Args> auto Submit(F&& f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>>;
+	template <class F, class... Args> auto Submit(const TaskOptions& options, F&& f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>>;
+	template <class F, class... Args> auto TrySubmit(F&& f, Args&&... args) -> std::optional<std::future<std::invoke_result_t<F, Args...>>>;
+	template <class F, class... Args> auto TrySubmit(const TaskOptions& options, F&& f, Args&&... args) -> std::optional<std::future<std::invoke_result_t<F, Args...>>>;
+	template <class F, class... Args> auto Execute(F&& f, Args&&... args) -> void;
+	template <class F, class... Args> auto Execute(const TaskOptions& options, F&& f, Args&&... args) -> void;
+	template <class F, class... Args> auto TryExecute(F&& f, Args&&... args) -> bool;
+	template <class InputIt> auto SubmitBatch(InputIt first, InputIt last) -> std::vector<std::future<std::invoke_result_t<std::decay_t<std::iter_reference_t<InputIt>>&>>>;
+	template <class F> auto SubmitBatch(size_t begin, size_t end, F&& f) -> std::future<void>;
+	[[nodiscard]] auto Schedule() noexcept -> ScheduleOperation;
 	auto Shutdown() -> void;
 	auto ShutdownNow() -> void;
+	auto SetGrowthThresholds(size_t queueDepth, std::chrono::milliseconds waitTime) -> void;
+	auto SetAgingInterval(std::chrono::milliseconds interval) -> void;
+	auto SetWorkerAffinity(std::vector<size_t> cpus, AffinityMode mode = AffinityMode::PerCpu) -> void;
+	auto SetRejectionPolicy(RejectionPolicy policy, std::chrono::milliseconds blockTimeout = DEFAULT_BLOCK_TIMEOUT) -> void;
+	[[nodiscard]] auto GetPoolSize() const -> size_t;
+	[[nodiscard]] auto GetStats() const -> ThreadPoolStats;
+	auto SetStatsCallback(std::function<void(const ThreadPoolStats&)> callback, std::chrono::milliseconds period) -> void;
 
 private:
-	auto Worker() -> void;
+	struct QueuedTask
+	{
+		TaskFunction task;
+		std::chrono::steady_clock::time_point enqueueTime;
+		static auto operator new(size_t size) -> void*;
+		static auto operator delete(void* block, size_t size) -> void;
+	};
+
+	struct WorkerSlot
+	{
+		WorkStealingQueue<QueuedTask*> localQueue;
+		WorkerMetrics metrics;
+	};
+
+	using TaskQueue = std::queue<QueuedTask, std::deque<QueuedTask, PooledAllocator<QueuedTask>>>;
+	static constexpr size_t PRIORITY_LEVELS = 3;
+	static constexpr std::chrono::milliseconds DEFAULT_AGING_INTERVAL{100};
+	static constexpr size_t DEFAULT_GROWTH_QUEUE_DEPTH = 64;
+	static constexpr std::chrono::milliseconds DEFAULT_GROWTH_WAIT_TIME{10};
+	static constexpr size_t LOCK_FREE_ROTATION_PERIOD = 16;
+	static constexpr std::chrono::milliseconds DEFAULT_BLOCK_TIMEOUT{1000};
+	auto Worker(size_t index, QueuedTask firstTask) -> void;
 	auto AddWorker() -> bool;
+	auto AddWorker(TaskFunction& firstTask) -> bool;
+	template <class R, class F> static auto FulfilPromise(std::promise<R>& promise, F&& func) -> void;
+	static auto RunTask(QueuedTask& task, WorkerMetrics& metrics) -> void;
+	auto TryRetireWorker(size_t index) -> bool;
+	auto ReapRetiredWorkers() -> void;
+	auto ApplyAffinity(size_t index) -> void;
+	auto JoinWorkers() -> void;
+	auto Enqueue(TaskFunction task, TaskPriority priority = TaskPriority::Normal) -> void;
+	auto TryEnqueue(TaskFunction& task, TaskPriority priority) -> bool;
+	auto PushTask(TaskFunction& task, TaskPriority priority) -> bool;
+	auto ApplyRejectionPolicy(TaskFunction& task, TaskPriority priority) -> bool;
+	auto WaitForRoom(std::chrono::steady_clock::time_point deadline) -> bool;
+	auto DiscardOldestTask() -> bool;
+	[[nodiscard]] auto HasRoom() const -> bool;
+	auto EnqueueBatch(std::vector<TaskFunction>& tasks) -> void;
+	auto TakeTask(size_t index, QueuedTask& out) -> bool;
+	auto PopLocalTask(size_t index, QueuedTask& out) -> bool;
+	auto PopSharedTask(QueuedTask& out) -> bool;
+	auto PopLockFreeTask(QueuedTask& out) -> bool;
+	auto ReserveLockFreeSlots(size_t count) -> bool;
+	static auto PushLockFreeTask(MpmcQueue<QueuedTask*>& queue, QueuedTask* task) -> void;
+	[[nodiscard]] auto SharedQueueSize() const -> size_t;
+	auto StealTask(size_t index, QueuedTask& out) -> bool;
+	auto NotifyIdleWorkers(size_t count) -> void;
+	auto DiscardLockFreeTasks() -> void;
+	auto GrowIfBacklogged(bool queueDelayed = false) -> void;
+	auto StopStatsReporter() -> void;
+	std::chrono::steady_clock::time_point createdAt_;
 	std::vector<std::thread> workers_;
-	std::queue<std::function<void()>> task_queue_;
+	std::vector<size_t> freeSlots_;
+	std::vector<size_t> retiredSlots_;
+	std::vector<size_t> affinityCpus_;
+	AffinityMode affinityMode_{AffinityMode::PerCpu};
+	std::mutex workersMutex_;
+	std::array<TaskQueue, PRIORITY_LEVELS> task_queues_;
+	std::array<std::unique_ptr<MpmcQueue<QueuedTask*>>, PRIORITY_LEVELS> lockFreeQueues_;
 	std::condition_variable condition_;
 	std::mutex queueMutex_;
 	std::atomic<bool> stop_;
@@ -43,5 +197,247 @@ private:
 	size_t maxThreadCount_;
 	size_t maxQueueSize_;
 	std::chrono::milliseconds threadIdleTime_;
+	SchedulingMode mode_;
+	std::vector<std::unique_ptr<WorkerSlot>> slots_;
+	std::atomic<size_t> pendingTaskCount_{0};
+	std::atomic<size_t> idleThreadCount_{0};
+	std::atomic<size_t> growthQueueDepth_{DEFAULT_GROWTH_QUEUE_DEPTH};
+	std::atomic<std::chrono::milliseconds> growthWaitTime_{DEFAULT_GROWTH_WAIT_TIME};
+	std::atomic<std::chrono::milliseconds> agingInterval_{DEFAULT_AGING_INTERVAL};
+	std::atomic<size_t> urgentTaskCount_{0};
+	std::atomic<uint64_t> rejectedTaskCount_{0};
+	std::atomic<RejectionPolicy> rejectionPolicy_{RejectionPolicy::Throw};
+	std::atomic<std::chrono::milliseconds> blockTimeout_{DEFAULT_BLOCK_TIMEOUT};
+	std::atomic<size_t> blockedProducerCount_{0};
+	std::condition_variable spaceCondition_;
+	std::thread statsReporter_;
+	std::mutex statsMutex_;
+	std::condition_variable statsCondition_;
+	std::function<void(const ThreadPoolStats&)> statsCallback_;
+	std::chrono::milliseconds statsPeriod_{0};
+	bool statsReporterStop_{false};
 };
+
+/// \brief Submit a task to the thread pool for execution.
+/// \tparam F The type of the function to be executed.
+/// \tparam Args The types of the arguments to be passed to the function.
+/// \param f The function to be executed.
+/// \param args The arguments to be passed to the function.
+/// \return A future object that will hold the result of the function execution.
+/// \throws std::runtime_error if the task queue is full, the pool cannot grow and the rejection policy rejects the task.
+/// \details This function stores the function, its arguments and a promise in a TaskFunction
+/// and adds it to the task queue. If the queue is full, the task is handed to a new
+/// worker while the pool is below max_threads; otherwise it throws an exception.
+/// A worker thread will eventually execute the task, and the result can be
+/// retrieved from the returned future object. In work-stealing mode a task submitted
+/// from one of the pool's own workers is pushed to that worker's local deque instead.
+/// Small tasks are stored inline and the shared state of the future is taken from a
+/// per-thread block cache, so a submission normally does not reach the global allocator.
+template <class F, class... Args> auto ThreadPool::Submit(F&& f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>> {
+	using return_type = std::invoke_result_t<F, Args...>;
+	std::promise<return_type> promise(std::allocator_arg, PooledAllocator<return_type>());
+	std::future<return_type> res = promise.get_future();
+	Enqueue([promise = std::move(promise), func = std::forward<F>(f), ...boundArgs = std::forward<Args>(args)]() mutable {
+		FulfilPromise(promise, [&] {
+			return std::invoke(func, boundArgs...);
+		});
+	});
+	return res;
+}
+
+/// \brief Submit a task with a priority and an optional deadline to the thread pool.
+/// \tparam F The type of the function to be executed.
+/// \tparam Args The types of the arguments to be passed to the function.
+/// \param options The priority and deadline of the task.
+/// \param f The function to be executed.
+/// \param args The arguments to be passed to the function.
+/// \return A future object that will hold the result of the function execution.
+/// \throws std::runtime_error if the task queue is full, the pool cannot grow and the rejection policy rejects the task.
+/// \details Behaves like Submit, but the task is queued at the given priority. If the deadline
+/// has passed when a worker picks the task up, the function is not called and the future
+/// reports a std::runtime_error.
+template <class F, class... Args> auto ThreadPool::Submit(const TaskOptions& options, F&& f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>> {
+	if (auto res = TrySubmit(options, std::forward<F>(f), std::forward<Args>(args)...)) {
+		return std::move(*res);
+	}
+	throw std::runtime_error("Task queue is full");
+}
+
+/// \brief Submit a task to the thread pool without throwing when it is rejected.
+/// \tparam F The type of the function to be executed.
+/// \tparam Args The types of the arguments to be passed to the function.
+/// \param f The function to be executed.
+/// \param args The arguments to be passed to the function.
+/// \return A future for the result, or std::nullopt if the task was rejected.
+/// \details Behaves like Submit under the current rejection policy, except that a rejected task
+/// is reported through the return value instead of an exception.
+template <class F, class... Args> auto ThreadPool::TrySubmit(F&& f, Args&&... args) -> std::optional<std::future<std::invoke_result_t<F, Args...>>> {
+	return TrySubmit(TaskOptions{}, std::forward<F>(f), std::forward<Args>(args)...);
+}
+
+/// \brief Submit a task with a priority and an optional deadline without throwing when it is rejected.
+/// \tparam F The type of the function to be executed.
+/// \tparam Args The types of the arguments to be passed to the function.
+/// \param options The priority and deadline of the task.
+/// \param f The function to be executed.
+/// \param args The arguments to be passed to the function.
+/// \return A future for the result, or std::nullopt if the task was rejected.
+template <class F, class... Args> auto ThreadPool::TrySubmit(const TaskOptions& options, F&& f, Args&&... args) -> std::optional<std::future<std::invoke_result_t<F, Args...>>> {
+	using return_type = std::invoke_result_t<F, Args...>;
+	std::promise<return_type> promise(std::allocator_arg, PooledAllocator<return_type>());
+	std::future<return_type> res = promise.get_future();
+	TaskFunction task([promise = std::move(promise), deadline = options.deadline, func = std::forward<F>(f), ...boundArgs = std::forward<Args>(args)]() mutable {
+		if (deadline && std::chrono::steady_clock::now() > *deadline) {
+			promise.set_exception(std::make_exception_ptr(std::runtime_error("Task deadline expired")));
+			return;
+		}
+		FulfilPromise(promise, [&] {
+			return std::invoke(func, boundArgs...);
+		});
+	});
+	if (!TryEnqueue(task, options.priority)) {
+		return std::nullopt;
+	}
+	return res;
+}
+
+/// \brief Execute a task on the thread pool without tracking its result.
+/// \tparam F The type of the function to be executed.
+/// \tparam Args The types of the arguments to be passed to the function.
+/// \param f The function to be executed.
+/// \param args The arguments to be passed to the function.
+/// \throws std::runtime_error if the task queue is full, the pool cannot grow and the rejection policy rejects the task.
+/// \details This is the fire-and-forget counterpart of Submit: no promise or future is
+/// created, so a small task costs no allocation at all. An exception escaping the task
+/// is discarded by the worker.
+template <class F, class... Args> auto ThreadPool::Execute(F&& f, Args&&... args) -> void {
+	Enqueue([func = std::forward<F>(f), ...boundArgs = std::forward<Args>(args)]() mutable {
+		std::invoke(func, boundArgs...);
+	});
+}
+/// \brief Execute a task with a priority and an optional deadline without tracking its result.
+/// \tparam F The type of the function to be executed.
+/// \tparam Args The types of the arguments to be passed to the function.
+/// \param options The priority and deadline of the task.
+/// \param f The function to be executed.
+/// \param args The arguments to be passed to the function.
+/// \throws std::runtime_error if the task queue is full, the pool cannot grow and the rejection policy rejects the task.
+/// \details The task is silently dropped if its deadline has passed when a worker picks it up.
+template <class F, class... Args> auto ThreadPool::Execute(const TaskOptions& options, F&& f, Args&&... args) -> void {
+	Enqueue([deadline = options.deadline, func = std::forward<F>(f), ...boundArgs = std::forward<Args>(args)]() mutable {
+		if (deadline && std::chrono::steady_clock::now() > *deadline) return;
+		std::invoke(func, boundArgs...);
+	}, options.priority);
+}
+
+/// \brief Execute a task on the thread pool without throwing when it is rejected.
+/// \tparam F The type of the function to be executed.
+/// \tparam Args The types of the arguments to be passed to the function.
+/// \param f The function to be executed.
+/// \param args The arguments to be passed to the function.
+/// \return true if the task was accepted, false if it was rejected.
+template <class F, class... Args> auto ThreadPool::TryExecute(F&& f, Args&&... args) -> bool {
+	TaskFunction task([func = std::forward<F>(f), ...boundArgs = std::forward<Args>(args)]() mutable {
+		std::invoke(func, boundArgs...);
+	});
+	return TryEnqueue(task, TaskPriority::Normal);
+}
+
+/// \brief Submit a batch of tasks to the thread pool for execution.
+/// \tparam InputIt An input iterator whose elements are callables taking no arguments.
+/// \param first The first callable of the batch.
+/// \param last One past the last callable of the batch.
+/// \return One future per callable, in the order of the range.
+/// \throws std::runtime_error if the task queue cannot hold the whole batch.
+/// \details The whole batch is enqueued under a single lock acquisition and only as many
+/// idle workers are woken as there are tasks. Elements are copied from the range; pass
+/// move iterators to move them instead.
+template <class InputIt> auto ThreadPool::SubmitBatch(InputIt first, InputIt last) -> std::vector<std::future<std::invoke_result_t<std::decay_t<std::iter_reference_t<InputIt>>&>>> {
+	using return_type = std::invoke_result_t<std::decay_t<std::iter_reference_t<InputIt>>&>;
+	std::vector<std::future<return_type>> results;
+	std::vector<TaskFunction> tasks;
+	for (; first != last; ++first) {
+		std::promise<return_type> promise(std::allocator_arg, PooledAllocator<return_type>());
+		results.push_back(promise.get_future());
+		tasks.emplace_back([promise = std::move(promise), func = std::decay_t<std::iter_reference_t<InputIt>>(*first)]() mutable {
+			FulfilPromise(promise, func);
+		});
+	}
+	EnqueueBatch(tasks);
+	return results;
+}
+
+/// \brief Submit one task per index of a range to the thread pool for execution.
+/// \tparam F The type of the function to be executed, callable with a size_t index.
+/// \param begin The first index.
+/// \param end One past the last index.
+/// \param f The function to be executed for every index; it is shared by all tasks.
+/// \return A single future that becomes ready when every index has been processed. If any
+/// call throws, the first exception is rethrown from the future once all tasks are done.
+/// \throws std::runtime_error if the task queue cannot hold the whole batch.
+/// \details The whole batch is enqueued under a single lock acquisition and only as many
+/// idle workers are woken as there are tasks.
+template <class F> auto ThreadPool::SubmitBatch(const size_t begin, const size_t end, F&& f) -> std::future<void> {
+	struct BatchState
+	{
+		BatchState(F&& func, const size_t count) : func(std::forward<F>(func)), remaining(count) {}
+		std::decay_t<F> func;
+		std::atomic<size_t> remaining;
+		std::atomic<bool> failed{false};
+		std::exception_ptr error;
+		std::promise<void> promise;
+	};
+
+	if (begin >= end) {
+		std::promise<void> promise;
+		promise.set_value();
+		return promise.get_future();
+	}
+	auto state = std::allocate_shared<BatchState>(PooledAllocator<BatchState>(), std::forward<F>(f), end - begin);
+	std::future<void> result = state->promise.get_future();
+	std::vector<TaskFunction> tasks;
+	tasks.reserve(end - begin);
+	for (size_t index = begin; index < end; ++index) {
+		tasks.emplace_back([state, index] {
+			try {
+				std::invoke(state->func, index);
+			}
+			catch (...) {
+				if (!state->failed.exchange(true)) {
+					state->error = std::current_exception();
+				}
+			}
+			if (--state->remaining == 0) {
+				if (state->failed) {
+					state->promise.set_exception(state->error);
+				}
+				else {
+					state->promise.set_value();
+				}
+			}
+		});
+	}
+	EnqueueBatch(tasks);
+	return result;
+}
+
+/// \brief Runs a callable and stores its result or exception in a promise.
+/// \tparam R The result type of the promise.
+/// \tparam F The type of the callable.
+/// \param promise The promise to fulfil.
+/// \param func The callable, invoked without arguments.
+template <class R, class F> auto ThreadPool::FulfilPromise(std::promise<R>& promise, F&& func) -> void {
+	try {
+		if constexpr (std::is_void_v<R>) {
+			std::invoke(std::forward<F>(func));
+			promise.set_value();
+		}
+		else {
+			promise.set_value(std::invoke(std::forward<F>(func)));
+		}
+	}
+	catch (...) {
+		promise.set_exception(std::current_exception());
+	}
+}
 }
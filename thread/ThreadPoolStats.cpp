@@ -0,0 +1,82 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#include "ThreadPoolStats.hpp"
+#include <bit>
+
+namespace common::thread
+{
+/// \brief Adds the samples of another snapshot to this one.
+/// \param other The snapshot to add.
+auto HistogramSnapshot::Merge(const HistogramSnapshot& other) -> void {
+	for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+		buckets[i] += other.buckets[i];
+	}
+	count += other.count;
+}
+
+/// \brief Returns an upper bound of the given percentile.
+/// \param percentile The percentile, between 0 and 100.
+/// \return The upper bound of the bucket holding the percentile, or zero if there are no samples.
+auto HistogramSnapshot::Percentile(const double percentile) const -> std::chrono::nanoseconds {
+	if (count == 0) {
+		return std::chrono::nanoseconds{0};
+	}
+	const auto rank = static_cast<uint64_t>(static_cast<double>(count) * std::min(std::max(percentile, 0.0), 100.0) / 100.0);
+	uint64_t seen = 0;
+	for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+		seen += buckets[i];
+		if (seen > rank || seen == count) {
+			return std::chrono::nanoseconds{(int64_t{1} << (i + 1)) - 1};
+		}
+	}
+	return std::chrono::nanoseconds{(int64_t{1} << BUCKET_COUNT) - 1};
+}
+
+/// \brief Records one latency sample.
+/// \param latency The sample; negative values count as zero and very large ones land in the last bucket.
+auto LatencyHistogram::Record(const std::chrono::nanoseconds latency) -> void {
+	const auto nanos = static_cast<uint64_t>(std::max<int64_t>(latency.count(), 0));
+	const size_t bucket = std::min<size_t>(nanos == 0 ? 0 : std::bit_width(nanos) - 1, HistogramSnapshot::BUCKET_COUNT - 1);
+	buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+/// \brief Copies the current bucket counts.
+/// \return The snapshot. Samples recorded concurrently may or may not be included.
+auto LatencyHistogram::Snapshot() const -> HistogramSnapshot {
+	HistogramSnapshot snapshot;
+	for (size_t i = 0; i < HistogramSnapshot::BUCKET_COUNT; ++i) {
+		snapshot.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+		snapshot.count += snapshot.buckets[i];
+	}
+	return snapshot;
+}
+
+/// \brief Records one executed task.
+/// \param queueWait The time the task spent queued.
+/// \param execution The time the task spent running.
+auto WorkerMetrics::Record(const std::chrono::nanoseconds queueWait, const std::chrono::nanoseconds execution) -> void {
+	tasksExecuted_.fetch_add(1, std::memory_order_relaxed);
+	busyNanos_.fetch_add(static_cast<uint64_t>(std::max<int64_t>(execution.count(), 0)), std::memory_order_relaxed);
+	queueWait_.Record(queueWait);
+	execution_.Record(execution);
+}
+
+/// \brief Returns the counters of this slot.
+/// \param uptime The uptime of the pool, used to compute the utilization.
+auto WorkerMetrics::Snapshot(const std::chrono::nanoseconds uptime) const -> WorkerStats {
+	WorkerStats stats;
+	stats.tasksExecuted = tasksExecuted_.load(std::memory_order_relaxed);
+	stats.busyTime = std::chrono::nanoseconds{static_cast<int64_t>(busyNanos_.load(std::memory_order_relaxed))};
+	if (uptime.count() > 0) {
+		stats.utilization = static_cast<double>(stats.busyTime.count()) / static_cast<double>(uptime.count());
+	}
+	return stats;
+}
+
+/// \brief Adds the latency histograms of this slot to a pool snapshot.
+/// \param stats The snapshot to update.
+auto WorkerMetrics::MergeHistogramsInto(ThreadPoolStats& stats) const -> void {
+	stats.queueWait.Merge(queueWait_.Snapshot());
+	stats.execution.Merge(execution_.Snapshot());
+}
+}
@@ -0,0 +1,77 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "CacheLine.hpp"
+
+namespace common::thread
+{
+/// \brief A point-in-time copy of a LatencyHistogram.
+/// \details Bucket i counts the samples in [2^i, 2^(i+1)) nanoseconds, bucket 0 also holds zero.
+struct HistogramSnapshot
+{
+	static constexpr size_t BUCKET_COUNT = 48;
+	std::array<uint64_t, BUCKET_COUNT> buckets{};
+	uint64_t count{0};
+	auto Merge(const HistogramSnapshot& other) -> void;
+	[[nodiscard]] auto Percentile(double percentile) const -> std::chrono::nanoseconds;
+};
+
+/// \brief A lock-free latency histogram with power-of-two buckets.
+/// \details Recording is a single relaxed increment, cheap enough to run for every task. The value reported
+/// for a percentile is the upper bound of the bucket it falls in, so it overestimates by at most a factor of two.
+class LatencyHistogram
+{
+public:
+	auto Record(std::chrono::nanoseconds latency) -> void;
+	[[nodiscard]] auto Snapshot() const -> HistogramSnapshot;
+
+private:
+	std::array<std::atomic<uint64_t>, HistogramSnapshot::BUCKET_COUNT> buckets_{};
+};
+
+/// \brief Counters of one worker slot in a ThreadPoolStats snapshot.
+struct WorkerStats
+{
+	uint64_t tasksExecuted{0};
+	std::chrono::nanoseconds busyTime{0};
+	double utilization{0.0};
+};
+
+/// \brief A snapshot of the state and counters of a ThreadPool.
+/// \details Counters are cumulative since the pool was created; diff two snapshots to get rates.
+/// Utilization is the share of the pool's uptime a worker slot spent running tasks.
+struct ThreadPoolStats
+{
+	size_t poolSize{0};
+	size_t idleThreads{0};
+	size_t queuedTasks{0};
+	uint64_t completedTasks{0};
+	uint64_t rejectedTasks{0};
+	std::chrono::nanoseconds uptime{0};
+	std::vector<WorkerStats> workers;
+	HistogramSnapshot queueWait;
+	HistogramSnapshot execution;
+};
+
+/// \brief The counters a single worker slot updates while running tasks.
+/// \details Each instance sits on its own cache lines so that workers never write to a line shared with
+/// another worker. Only the worker owning the slot records; snapshots may be taken from any thread.
+class alignas(CACHE_LINE_SIZE) WorkerMetrics
+{
+public:
+	auto Record(std::chrono::nanoseconds queueWait, std::chrono::nanoseconds execution) -> void;
+	[[nodiscard]] auto Snapshot(std::chrono::nanoseconds uptime) const -> WorkerStats;
+	auto MergeHistogramsInto(ThreadPoolStats& stats) const -> void;
+
+private:
+	std::atomic<uint64_t> tasksExecuted_{0};
+	std::atomic<uint64_t> busyNanos_{0};
+	LatencyHistogram queueWait_;
+	LatencyHistogram execution_;
+};
+}
@@ -0,0 +1,47 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#include "TicketMutex.hpp"
+#include "Backoff.hpp"
+
+namespace common::thread
+{
+TicketMutex::TicketMutex() : nextTicket_(0), nowServing_(0), parked_(0) {}
+
+/// \brief Acquires the lock once every thread that arrived earlier has released it.
+auto TicketMutex::lock() -> void {
+	const uint32_t ticket = nextTicket_.fetch_add(1, std::memory_order_relaxed);
+	Backoff backoff;
+	for (uint32_t serving = nowServing_.load(std::memory_order_acquire); serving != ticket; serving = nowServing_.load(std::memory_order_acquire)) {
+		if (backoff.Exhausted()) {
+			// Registering before the final check pairs with the check in unlock, so the wake-up cannot be lost.
+			parked_.fetch_add(1);
+			nowServing_.wait(serving);
+			parked_.fetch_sub(1, std::memory_order_relaxed);
+			continue;
+		}
+		// Threads further back in line have longer to wait, so they poll less often.
+		for (uint32_t ahead = ticket - serving; ahead > 1; --ahead) {
+			backoff.Pause();
+		}
+		backoff.Pause();
+	}
+}
+
+/// \brief Tries to acquire the lock without blocking.
+/// \details Succeeds only if nobody holds or waits for the lock, so it never jumps the queue.
+/// \return true if the lock was acquired, false otherwise.
+auto TicketMutex::try_lock() -> bool {
+	uint32_t ticket = nowServing_.load(std::memory_order_relaxed);
+	return nextTicket_.compare_exchange_strong(ticket, ticket + 1, std::memory_order_acquire, std::memory_order_relaxed);
+}
+
+/// \brief Releases the lock and hands it to the next ticket in line.
+/// \details The notification, a system call, is skipped unless a waiter has parked.
+auto TicketMutex::unlock() -> void {
+	// Only the holder writes nowServing_, so a plain load and store suffice.
+	nowServing_.store(nowServing_.load(std::memory_order_relaxed) + 1);
+	if (parked_.load() != 0) {
+		nowServing_.notify_all();
+	}
+}
+}
@@ -0,0 +1,32 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include "CacheLine.hpp"
+
+namespace common::thread
+{
+/// \brief A fair first-in first-out spinlock.
+/// \details Every thread draws a ticket and waits until the ticket being served reaches it, so the lock
+/// is granted strictly in arrival order and no thread can starve. Waiters spin on the counter of the
+/// ticket being served, backing off in proportion to how far back in line they are, and park on
+/// std::atomic::wait once their spin budget is spent. An unlock only notifies when a waiter has parked,
+/// but then it wakes every parked waiter, since they all wait on the same counter; all but the next
+/// ticket holder go back to sleep. All waiters watch the same cache line, so for many threads ClhMutex
+/// scales better. Strict ordering has a price when threads outnumber cores: if the
+/// next ticket holder is descheduled, nobody can take the lock until it runs again.
+class TicketMutex
+{
+public:
+	TicketMutex();
+	auto lock() -> void;
+	auto try_lock() -> bool;
+	auto unlock() -> void;
+
+private:
+	alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> nextTicket_;
+	alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> nowServing_;
+	std::atomic<uint32_t> parked_;
+};
+}
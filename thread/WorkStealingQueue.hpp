@@ -0,0 +1,170 @@
+// Created by author ethereal on 2026/10/17.
+// Copyright (c) 2026 ethereal. All rights reserved.
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+#include "CacheLine.hpp"
+
+namespace common::thread
+{
+/// \brief A lock-free work-stealing deque (Chase-Lev).
+/// \tparam T The element type. It must be trivially copyable, typically a pointer to a task.
+/// \details The owning thread pushes and pops at the bottom end without taking any lock, while any other
+/// thread may steal from the top end. Only the owner may call Push and Pop; Steal, Size and Empty are safe
+/// from every thread. The ring buffer grows on demand; retired buffers are kept until the deque is destroyed
+/// because a concurrent thief may still be reading from them.
+template <typename T> class WorkStealingQueue
+{
+	static_assert(std::is_trivially_copyable_v<T>, "WorkStealingQueue elements must be trivially copyable");
+
+public:
+	explicit WorkStealingQueue(size_t capacity = DEFAULT_CAPACITY);
+	WorkStealingQueue(const WorkStealingQueue&) = delete;
+	auto operator=(const WorkStealingQueue&) -> WorkStealingQueue& = delete;
+	auto Push(T item) -> void;
+	auto Pop() -> std::optional<T>;
+	auto Steal() -> std::optional<T>;
+	[[nodiscard]] auto Size() const -> size_t;
+	[[nodiscard]] auto Empty() const -> bool;
+
+private:
+	class Buffer
+	{
+	public:
+		explicit Buffer(size_t capacity);
+		[[nodiscard]] auto Capacity() const -> int64_t;
+		[[nodiscard]] auto Get(int64_t index) const -> T;
+		auto Put(int64_t index, T item) -> void;
+		[[nodiscard]] auto Grow(int64_t bottom, int64_t top) const -> std::unique_ptr<Buffer>;
+
+	private:
+		int64_t capacity_;
+		int64_t mask_;
+		std::unique_ptr<std::atomic<T>[]> slots_;
+	};
+
+	static constexpr size_t DEFAULT_CAPACITY = 256;
+	alignas(CACHE_LINE_SIZE) std::atomic<int64_t> top_{0};
+	alignas(CACHE_LINE_SIZE) std::atomic<int64_t> bottom_{0};
+	alignas(CACHE_LINE_SIZE) std::atomic<Buffer*> buffer_{nullptr};
+	std::vector<std::unique_ptr<Buffer>> buffers_;
+};
+
+/// \brief Creates a ring buffer whose capacity is rounded up to a power of two.
+/// \param capacity The requested number of slots.
+template <typename T> WorkStealingQueue<T>::Buffer::Buffer(const size_t capacity) {
+	size_t rounded = 1;
+	while (rounded < capacity) {
+		rounded <<= 1;
+	}
+	capacity_ = static_cast<int64_t>(rounded);
+	mask_ = capacity_ - 1;
+	slots_ = std::make_unique<std::atomic<T>[]>(rounded);
+}
+
+/// \brief Returns the number of slots of the ring buffer.
+template <typename T> auto WorkStealingQueue<T>::Buffer::Capacity() const -> int64_t {
+	return capacity_;
+}
+
+/// \brief Reads the element stored at the given logical index.
+template <typename T> auto WorkStealingQueue<T>::Buffer::Get(const int64_t index) const -> T {
+	return slots_[index & mask_].load(std::memory_order_relaxed);
+}
+
+/// \brief Stores an element at the given logical index.
+template <typename T> auto WorkStealingQueue<T>::Buffer::Put(const int64_t index, T item) -> void {
+	slots_[index & mask_].store(item, std::memory_order_relaxed);
+}
+
+/// \brief Creates a buffer twice as large holding the elements in [top, bottom).
+template <typename T> auto WorkStealingQueue<T>::Buffer::Grow(const int64_t bottom, const int64_t top) const -> std::unique_ptr<Buffer> {
+	auto grown = std::make_unique<Buffer>(static_cast<size_t>(capacity_) * 2);
+	for (int64_t i = top; i != bottom; ++i) {
+		grown->Put(i, Get(i));
+	}
+	return grown;
+}
+
+/// \brief WorkStealingQueue constructor
+/// \param capacity The initial number of slots; the deque grows beyond it when needed.
+template <typename T> WorkStealingQueue<T>::WorkStealingQueue(const size_t capacity) {
+	buffers_.push_back(std::make_unique<Buffer>(capacity == 0 ? DEFAULT_CAPACITY : capacity));
+	buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+}
+
+/// \brief Pushes an element at the bottom end of the deque.
+/// \details Must only be called by the owning thread. Grows the ring buffer if it is full.
+/// \param item The element to push.
+template <typename T> auto WorkStealingQueue<T>::Push(T item) -> void {
+	const int64_t bottom = bottom_.load(std::memory_order_relaxed);
+	const int64_t top = top_.load(std::memory_order_acquire);
+	Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+	if (bottom - top > buffer->Capacity() - 1) {
+		buffers_.push_back(buffer->Grow(bottom, top));
+		buffer = buffers_.back().get();
+		buffer_.store(buffer, std::memory_order_release);
+	}
+	buffer->Put(bottom, item);
+	std::atomic_thread_fence(std::memory_order_release);
+	bottom_.store(bottom + 1, std::memory_order_relaxed);
+}
+
+/// \brief Pops the most recently pushed element from the bottom end of the deque.
+/// \details Must only be called by the owning thread. Races with thieves only for the last element.
+/// \return The element, or std::nullopt if the deque is empty.
+template <typename T> auto WorkStealingQueue<T>::Pop() -> std::optional<T> {
+	const int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+	Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+	bottom_.store(bottom, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t top = top_.load(std::memory_order_relaxed);
+	if (top > bottom) {
+		bottom_.store(bottom + 1, std::memory_order_relaxed);
+		return std::nullopt;
+	}
+	std::optional<T> item = buffer->Get(bottom);
+	if (top == bottom) {
+		if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+			item.reset();
+		}
+		bottom_.store(bottom + 1, std::memory_order_relaxed);
+	}
+	return item;
+}
+
+/// \brief Steals the oldest element from the top end of the deque.
+/// \details May be called from any thread. Returns std::nullopt both when the deque is empty and when
+/// the steal lost a race against the owner or another thief; callers simply try another victim.
+/// \return The stolen element, or std::nullopt.
+template <typename T> auto WorkStealingQueue<T>::Steal() -> std::optional<T> {
+	int64_t top = top_.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	const int64_t bottom = bottom_.load(std::memory_order_acquire);
+	if (top >= bottom) {
+		return std::nullopt;
+	}
+	const Buffer* buffer = buffer_.load(std::memory_order_acquire);
+	T item = buffer->Get(top);
+	if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+		return std::nullopt;
+	}
+	return item;
+}
+
+/// \brief Returns an approximation of the number of elements in the deque.
+template <typename T> auto WorkStealingQueue<T>::Size() const -> size_t {
+	const int64_t bottom = bottom_.load(std::memory_order_relaxed);
+	const int64_t top = top_.load(std::memory_order_relaxed);
+	return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+}
+
+/// \brief Tests whether the deque currently looks empty.
+template <typename T> auto WorkStealingQueue<T>::Empty() const -> bool {
+	return Size() == 0;
+}
+}